@@ -0,0 +1,147 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replacing the global allocation functions lets the suites count heap
+// allocations made by the library without any hooks inside it. Every
+// replaceable form is covered, so an over-aligned or nothrow allocation
+// cannot slip past the count.
+static std::atomic<std::size_t> allocations{0};
+
+std::size_t Bench::AllocationCount()
+{
+  return allocations.load(std::memory_order_relaxed);
+}
+
+static void* Allocate(const std::size_t size) noexcept
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+// Over-aligned blocks come from malloc too, with the block's own address stored
+// just in front of the aligned pointer so the aligned deletes can free it.
+static void* AllocateAligned(const std::size_t size, const std::align_val_t alignment) noexcept
+{
+  const auto align = static_cast<std::size_t>(alignment);
+  void* block = Allocate(size + align + sizeof(void*));
+  if (block == nullptr) return nullptr;
+
+  const auto address = reinterpret_cast<std::uintptr_t>(block) + sizeof(void*);
+  void* aligned = reinterpret_cast<void*>((address + align - 1) & ~(align - 1));
+  static_cast<void**>(aligned)[-1] = block;
+  return aligned;
+}
+
+static void FreeAligned(void* memory) noexcept
+{
+  if (memory != nullptr) std::free(static_cast<void**>(memory)[-1]);
+}
+
+void* operator new(const std::size_t size)
+{
+  if (void* memory = Allocate(size)) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+  return Allocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+  return Allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+  if (void* memory = AllocateAligned(size, alignment)) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+  return ::operator new(size, alignment);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return AllocateAligned(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+  FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+  FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+  FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+  FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  FreeAligned(memory);
+}
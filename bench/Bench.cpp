@@ -0,0 +1,111 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+namespace
+{
+  struct Result
+  {
+    std::string suite;
+    std::string name;
+    std::size_t bytes;
+    double seconds;
+    std::optional<double> allocations;
+  };
+
+  std::vector<Result> results;
+  std::string currentSuite;
+  bool unexpected = false;
+
+  void Record(std::string_view name, const std::size_t bytes, const double seconds, const std::optional<double> allocations)
+  {
+    while (!name.empty() && name.front() == ' ') name.remove_prefix(1);
+    results.push_back({currentSuite, std::string(name), bytes, seconds, allocations});
+  }
+}
+
+std::string Bench::GenerateRecords(const std::size_t count)
+{
+  std::string result = "[";
+  result.reserve(count * 160);
+
+  // Tiny LCG so every run produces byte-identical input.
+  unsigned int state = 12345;
+  auto next = [&state]() { state = state * 1103515245u + 12345u; return (state >> 8) % 100000; };
+
+  for (std::size_t i = 0; i < count; i++)
+  {
+    if (i != 0) result += ",\n";
+    result += R"({"id": )" + std::to_string(i);
+    result += R"(, "name": "user_)" + std::to_string(next());
+    result += R"(", "score": )" + std::to_string(next()) + "." + std::to_string(next() % 100);
+    result += R"(, "active": )";
+    result += (next() % 2) ? "true" : "false";
+    result += R"(, "tags": ["alpha", "beta", "gamma"], "parent": null, "note": "line\nbreak é"})";
+  }
+
+  result += "]";
+  return result;
+}
+
+void Bench::Report(const std::string_view name, const std::size_t bytes, const double seconds)
+{
+  const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+  std::printf("%-40.*s %10.1f MB/s %12.3f ms\n", static_cast<int>(name.size()), name.data(),
+              megabytes / seconds, seconds * 1000.0);
+  Record(name, bytes, seconds, std::nullopt);
+}
+
+void Bench::ReportStage(const std::string_view name, const std::size_t bytes, const double seconds, const double allocations)
+{
+  const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+  std::printf("%-40.*s %10.1f MB/s %12.3f ms %10.1f docs/s %10.1f allocs/doc\n", static_cast<int>(name.size()), name.data(),
+              megabytes / seconds, seconds * 1000.0, 1.0 / seconds, allocations);
+  Record(name, bytes, seconds, allocations);
+}
+
+void Bench::Unexpected(const std::string_view message)
+{
+  std::printf("  UNEXPECTED: %.*s\n", static_cast<int>(message.size()), message.data());
+  unexpected = true;
+}
+
+bool Bench::AnyUnexpected()
+{
+  return unexpected;
+}
+
+void Bench::BeginSuite(const std::string_view name)
+{
+  currentSuite = name;
+}
+
+/**
+ * Writes {"results": [...]} with one object per reported line, so runs can be compared over time.
+ */
+void Bench::SaveResults(const std::string& filepath)
+{
+  std::vector<JSONValue> entries;
+  for (const Result& result : results)
+  {
+    JSONValue entry{JSONObject()};
+    entry["suite"] = JSONValue{result.suite};
+    entry["name"] = JSONValue{result.name};
+    entry["bytes"] = JSONValue{static_cast<uint64_t>(result.bytes)};
+    entry["seconds"] = JSONValue{result.seconds};
+    entry["megabytes_per_second"] = JSONValue{static_cast<double>(result.bytes) / (1024.0 * 1024.0) / result.seconds};
+    entry["documents_per_second"] = JSONValue{1.0 / result.seconds};
+    if (result.allocations) entry["allocations_per_document"] = JSONValue{*result.allocations};
+    entries.push_back(std::move(entry));
+  }
+
+  JSONValue root{JSONObject()};
+  root["results"] = JSONValue{std::move(entries)};
+  JSON::SaveToFile(filepath, root);
+}
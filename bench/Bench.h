@@ -0,0 +1,96 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace Bench
+ * @brief Small helpers shared by the JSONParserBench suites.
+ *
+ * Every suite generates its input deterministically, so numbers are comparable
+ * between runs and machines without shipping corpus files.
+ */
+namespace Bench
+{
+  /// Generate an array of `count` record-style objects with a fixed set of keys.
+  std::string GenerateRecords(std::size_t count);
+
+  // Corpora shaped like the ones commonly used to compare parsers, see Corpora.cpp.
+  std::string GenerateTwitter(std::size_t tweets);
+  std::string GenerateCanada(std::size_t points);
+  std::string GenerateCitm(std::size_t events);
+  std::string GenerateDeep(std::size_t trees, std::size_t depth);
+
+  /// Print a single result line: name, throughput in MB/s and time per iteration.
+  void Report(std::string_view name, std::size_t bytes, double seconds);
+
+  /// Print a result line for one document processed by one stage, adding documents per
+  /// second and heap allocations per document.
+  void ReportStage(std::string_view name, std::size_t bytes, double seconds, double allocations);
+
+  /// Print a failed check of a suite. Once a check has failed, the benchmark exits with status 1.
+  void Unexpected(std::string_view message);
+  [[nodiscard]] bool AnyUnexpected();
+
+  /// Record the following results under the suite `name`.
+  void BeginSuite(std::string_view name);
+
+  /// Write every result reported so far to `filepath` as a JSON document.
+  void SaveResults(const std::string& filepath);
+
+  /// Run `function` `iterations` times and return the fastest run in seconds.
+  template <typename Function>
+  double Measure(Function&& function, const int iterations)
+  {
+    double best = 1e300;
+    for (int i = 0; i < iterations; i++)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      function();
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      if (elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+  }
+
+  /// Number of global operator new calls made so far by the process.
+  std::size_t AllocationCount();
+
+  /// Keep the optimiser from discarding a result.
+  template <typename T>
+  void DoNotOptimize(const T& value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+  }
+
+  // Suites
+  void RunStreamingBench();
+  void RunLexerBench();
+  void RunDocumentBench();
+  void RunObjectBench();
+  void RunOnDemandBench();
+  void RunSaxBench();
+  void RunLinesBench();
+  void RunParallelBench();
+  void RunNumberBench();
+  void RunWriterBench();
+  void RunStringBench();
+  void RunPathBench();
+  void RunBindBench();
+  void RunSnapshotBench();
+  void RunTapeBench();
+  void RunReuseBench();
+  void RunCorporaBench();
+  void RunDepthBench();
+  void RunUTF8Bench();
+}
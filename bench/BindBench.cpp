@@ -0,0 +1,101 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "JSONBind.h"
+#include <cstdio>
+
+namespace
+{
+  /// One element of Bench::GenerateRecords.
+  struct Record
+  {
+    int64_t id = 0;
+    std::string name;
+    double score = 0;
+    bool active = false;
+    std::vector<std::string> tags;
+    std::optional<std::string> parent;
+    std::string note;
+  };
+}
+
+JSON_BIND(Record, id, name, score, active, tags, parent, note)
+
+/**
+ * Fills a vector of structs from the records corpus, once by parsing a JSONValue tree and
+ * copying the fields out by hand, and once with a JSONBinder that reads the tokens directly.
+ * Then writes the structs back, once through a JSONValue tree and once with JSONBinder::Write.
+ */
+void Bench::RunBindBench()
+{
+  const std::string source = GenerateRecords(20000);
+  std::printf("\n--- Struct binding (%zu records) ---\n", static_cast<std::size_t>(20000));
+
+  const double parsed = Measure([&source]()
+  {
+    const JSONValue root = JSON::Parse(source);
+    std::vector<Record> records;
+    records.reserve(root.AsArray().size());
+    for (const JSONValue& element : root.AsArray())
+    {
+      Record& record = records.emplace_back();
+      record.id = element["id"].AsInt64();
+      record.name = element["name"].AsString();
+      record.score = element["score"].AsDouble();
+      record.active = element["active"].AsBool();
+      for (const JSONValue& tag : element["tags"].AsArray()) record.tags.push_back(tag.AsString());
+      if (!element["parent"].IsNull()) record.parent = element["parent"].AsString();
+      record.note = element["note"].AsString();
+    }
+    DoNotOptimize(records);
+  }, 5);
+  Report("JSON::Parse + copy into structs", source.size(), parsed);
+
+  const double bound = Measure([&source]()
+  {
+    DoNotOptimize(JSONBinder<std::vector<Record>>::Parse(source));
+  }, 5);
+  Report("JSONBinder<std::vector<Record>>", source.size(), bound);
+
+  std::vector<Record> reused;
+  const double reuse = Measure([&source, &reused]()
+  {
+    JSONBinder<std::vector<Record>>::Parse(source, reused);
+    DoNotOptimize(reused);
+  }, 5);
+  Report("JSONBinder into a reused vector", source.size(), reuse);
+
+  // Write the same records back out.
+  std::string buffer;
+  const double tree = Measure([&reused, &buffer]()
+  {
+    JSONValue root{std::vector<JSONValue>{}};
+    for (const Record& record : reused)
+    {
+      JSONValue element{JSONObject{}};
+      element["id"] = JSONValue{record.id};
+      element["name"] = JSONValue{record.name};
+      element["score"] = JSONValue{record.score};
+      element["active"] = JSONValue{record.active};
+      JSONValue tags{std::vector<JSONValue>{}};
+      for (const std::string& tag : record.tags) tags.AsArray().push_back(JSONValue{tag});
+      element["tags"] = std::move(tags);
+      element["parent"] = record.parent ? JSONValue{*record.parent} : JSONValue{};
+      element["note"] = JSONValue{record.note};
+      root.AsArray().push_back(std::move(element));
+    }
+    buffer = root.ToString();
+    DoNotOptimize(buffer);
+  }, 5);
+  const double written = Measure([&reused, &buffer]()
+  {
+    buffer.clear();
+    JSONBinder<std::vector<Record>>::Write(reused, buffer);
+    DoNotOptimize(buffer);
+  }, 5);
+  Report("build JSONValue + ToString", buffer.size(), tree);
+  Report("JSONBinder::Write into a reused buffer", buffer.size(), written);
+}
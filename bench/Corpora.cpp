@@ -0,0 +1,166 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include <cstdio>
+
+/**
+ * Generators shaped after the corpora commonly used to compare JSON parsers. They are not
+ * copies of those files, but reproduce what makes each of them hard: long escaped strings
+ * and deep records (twitter), long runs of high-precision floats (canada), many small
+ * objects keyed by numeric ids (citm), and deep nesting.
+ */
+namespace
+{
+  /// Tiny LCG so every run produces byte-identical input.
+  class Random
+  {
+  public:
+    explicit Random(const unsigned int seed) : m_state(seed) {}
+
+    unsigned int Next(const unsigned int bound)
+    {
+      m_state = m_state * 1103515245u + 12345u;
+      return (m_state >> 8) % bound;
+    }
+
+    std::string Word()
+    {
+      static constexpr const char* words[] = {
+        "json", "parser", "fast", "tape", "token", "cache", "vector", "simd", "stream", "value",
+        "object", "array", "number", "string", "escape", "unicode", "nested", "record", "bench", "spark"
+      };
+      return words[Next(20)];
+    }
+
+  private:
+    unsigned int m_state;
+  };
+}
+
+std::string Bench::GenerateTwitter(const std::size_t tweets)
+{
+  Random random(1);
+  std::string result = R"({"statuses": [)";
+  result.reserve(tweets * 2400);
+
+  for (std::size_t i = 0; i < tweets; i++)
+  {
+    const std::string id = std::to_string(505874924095815680ull + i * 7919);
+    const std::string user = "user_" + std::to_string(random.Next(1000000));
+    const std::string tag = random.Word();
+
+    std::string text = "RT @" + user + ": ";
+    for (unsigned int word = random.Next(12) + 4; word != 0; word--) text += random.Word() + " ";
+    text += R"(【私】 café \"quoted\" #)" + tag + R"( https:\/\/t.co\/)" + std::to_string(random.Next(99999));
+
+    if (i != 0) result += ",\n";
+    result += R"({"metadata": {"result_type": "recent", "iso_language_code": "ja"}, "created_at": "Sun Aug 31 00:29:15 +0000 2014", )";
+    result += R"("id": )" + id + R"(, "id_str": ")" + id + R"(", "text": ")" + text + R"(", )";
+    result += R"("source": "<a href=\"https://twitter.com\" rel=\"nofollow\">Web Client<\/a>", "truncated": false, )";
+    result += R"("in_reply_to_status_id": null, "in_reply_to_user_id": null, "user": {"id": )" + std::to_string(random.Next(2000000000));
+    result += R"(, "name": ")" + user + R"(", "screen_name": ")" + user + R"(", "location": "東京", )";
+    result += R"("description": ")" + random.Word() + " " + random.Word() + R"(\n)" + random.Word() + R"(", "url": null, )";
+    result += R"("followers_count": )" + std::to_string(random.Next(100000)) + R"(, "friends_count": )" + std::to_string(random.Next(5000));
+    result += R"(, "verified": false, "lang": "ja", "profile_background_color": "C0DEED", "profile_use_background_image": true}, )";
+    result += R"("geo": null, "coordinates": null, "retweet_count": )" + std::to_string(random.Next(500));
+    result += R"(, "favorite_count": )" + std::to_string(random.Next(500)) + R"(, "entities": {"hashtags": [{"text": ")" + tag;
+    result += R"(", "indices": [)" + std::to_string(random.Next(100)) + ", " + std::to_string(random.Next(100) + 100);
+    result += R"(]}], "symbols": [], "urls": [], "user_mentions": [{"screen_name": ")" + user + R"(", "id": )" + std::to_string(random.Next(1000000));
+    result += R"(, "indices": [3, 12]}]}, "favorited": false, "retweeted": false, "lang": "ja"})";
+  }
+
+  result += R"(], "search_metadata": {"completed_in": 0.087, "max_id": 505874924095815681, "query": "%E4%B8%80", "count": )";
+  result += std::to_string(tweets) + "}}";
+  return result;
+}
+
+std::string Bench::GenerateCanada(const std::size_t points)
+{
+  Random random(2);
+  std::string result = R"({"type": "FeatureCollection", "features": [{"type": "Feature", "properties": {"name": "Canada"}, )";
+  result += R"("geometry": {"type": "Polygon", "coordinates": [)";
+  result.reserve(points * 44);
+
+  char buffer[64];
+  for (std::size_t i = 0; i < points; i++)
+  {
+    // Polygons of a few hundred points each, with coordinates carrying 15 significant digits.
+    if (i % 400 == 0) result += i == 0 ? "[" : "], [";
+    else result += ",";
+    const double longitude = -141.0 + random.Next(8000000) / 100000.0 + random.Next(1000000) / 1e12;
+    const double latitude = 41.0 + random.Next(4200000) / 100000.0 + random.Next(1000000) / 1e12;
+    std::snprintf(buffer, sizeof(buffer), "[%.15f,%.15f]", longitude, latitude);
+    result += buffer;
+  }
+
+  result += "]]}}]}";
+  return result;
+}
+
+std::string Bench::GenerateCitm(const std::size_t events)
+{
+  Random random(3);
+  std::string result = R"({"areaNames": {)";
+  result.reserve(events * 1200);
+
+  for (std::size_t i = 0; i < 64; i++)
+  {
+    if (i != 0) result += ", ";
+    result += "\"" + std::to_string(205705993 + i) + R"(": "Arrière-scène )" + random.Word() + "\"";
+  }
+
+  result += R"(}, "events": {)";
+  for (std::size_t i = 0; i < events; i++)
+  {
+    const std::string id = std::to_string(138586341 + i * 4);
+    if (i != 0) result += ",\n";
+    result += "\"" + id + R"(": {"description": null, "id": )" + id + R"(, "logo": "/images/UE0AAAAACEKo6QAAAAZDSVRN", "name": ")";
+    result += random.Word() + " " + random.Word() + R"(", "subTopicIds": [337184284, 337184263, 337184298], "subjectCode": null, )";
+    result += R"("subtitle": null, "topicIds": [324846099, )" + std::to_string(107888604 + random.Next(10)) + "]}";
+  }
+
+  result += R"(}, "performances": [)";
+  for (std::size_t i = 0; i < events; i++)
+  {
+    if (i != 0) result += ",\n";
+    result += R"({"eventId": )" + std::to_string(138586341 + i * 4) + R"(, "id": )" + std::to_string(339887544 + i);
+    result += R"(, "logo": null, "name": null, "prices": [)";
+    for (unsigned int price = 0; price < 3; price++)
+    {
+      if (price != 0) result += ", ";
+      result += R"({"amount": )" + std::to_string(9025 * (random.Next(20) + 1));
+      result += R"(, "audienceSubCategoryId": 337100890, "seatCategoryId": )" + std::to_string(338937295 + price) + "}";
+    }
+    result += R"(], "seatCategories": [{"areas": [{"areaId": 205705999, "blockIds": []}, {"areaId": 205705998, "blockIds": []}], )";
+    result += R"("seatCategoryId": 338937295}], "seatMapImage": null, "start": )" + std::to_string(1372701600000ull + i * 86400000ull);
+    result += R"(, "venueCode": "PLEYEL_PLEYEL"})";
+  }
+
+  result += "]}";
+  return result;
+}
+
+std::string Bench::GenerateDeep(const std::size_t trees, const std::size_t depth)
+{
+  Random random(4);
+  std::string result = "[";
+  result.reserve(trees * depth * 24);
+
+  for (std::size_t tree = 0; tree < trees; tree++)
+  {
+    if (tree != 0) result += ",\n";
+    // Alternate objects and arrays all the way down, with a scalar at every level.
+    for (std::size_t level = 0; level < depth; level++)
+    {
+      if (level % 2 == 0) result += R"({"level": )" + std::to_string(level) + R"(, "child": )";
+      else result += "[" + std::to_string(random.Next(1000)) + ", ";
+    }
+    result += "null";
+    for (std::size_t level = depth; level-- > 0;) result += level % 2 == 0 ? "}" : "]";
+  }
+
+  result += "]";
+  return result;
+}
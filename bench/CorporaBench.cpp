@@ -0,0 +1,66 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * Runs every processing stage separately on each generated corpus: lexing to a token vector,
+ * parsing to a JSONValue, serializing it, and the file round trip. Allocations are counted
+ * through the operator new hook, so file mappings and arena chunks are not included.
+ * An instrumented parse then breaks the parse down by stage, see ParseStats.
+ */
+void Bench::RunCorporaBench()
+{
+  const struct
+  {
+    const char* name;
+    std::string text;
+  } corpora[] = {
+    {"twitter", GenerateTwitter(400)},
+    {"canada", GenerateCanada(56000)},
+    {"citm", GenerateCitm(1200)},
+    {"deep", GenerateDeep(100, 200)},
+  };
+
+  const std::string path = (std::filesystem::temp_directory_path() / "JSONParserBench.corpus.json").string();
+  constexpr int iterations = 5;
+
+  for (const auto& corpus : corpora)
+  {
+    std::printf("\n--- Corpus %s (%zu bytes) ---\n", corpus.name, corpus.text.size());
+    std::ofstream(path, std::ios::binary) << corpus.text;
+    const JSONValue value = Parser::Parse(corpus.text);
+
+    const auto stage = [&](const char* name, auto&& function)
+    {
+      const std::size_t before = AllocationCount();
+      const double seconds = Measure(function, iterations);
+      const double allocations = static_cast<double>(AllocationCount() - before) / iterations;
+      ReportStage(std::string(corpus.name) + " " + name, corpus.text.size(), seconds, allocations);
+    };
+
+    stage("Lexer::Tokenize", [&]() { DoNotOptimize(Lexer::Tokenize(corpus.text)); });
+    stage("Parser::Parse", [&]() { DoNotOptimize(Parser::Parse(corpus.text)); });
+    stage("JSONValue::ToString", [&]() { DoNotOptimize(value.ToString()); });
+    stage("JSON::LoadFromFile", [&]() { DoNotOptimize(JSON::LoadFromFile(path)); });
+    stage("JSON::SaveToFile", [&]() { JSON::SaveToFile(path, value); });
+
+    // Where an instrumented parse spends its time; the clock reads inflate the total.
+    ParseStats stats;
+    DoNotOptimize(JSON::Parse(corpus.text, stats));
+    const auto share = [&stats](const uint64_t nanoseconds) { return 100.0 * static_cast<double>(nanoseconds) / static_cast<double>(stats.totalNanoseconds); };
+    std::printf("  instrumented parse: %zu tokens, depth %zu, %zu bytes unescaped, %zu allocations (%zu bytes)\n",
+                stats.tokens, stats.maxDepth, stats.unescapedBytes, stats.allocations, stats.allocatedBytes);
+    std::printf("  time: lex %.0f%%, numbers %.0f%%, strings %.0f%%, building %.0f%%\n", share(stats.lexNanoseconds),
+                share(stats.numberNanoseconds), share(stats.stringNanoseconds), share(stats.buildNanoseconds));
+  }
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,220 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "JSONSax.h"
+#include "JSONStreamParser.h"
+#include "JSONWriter.h"
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+  /// Counts containers, so the SAX parse has something to do per event.
+  struct ContainerCount
+  {
+    std::size_t containers = 0;
+
+    void OnObjectStart() { containers++; }
+    void OnObjectEnd() {}
+    void OnArrayStart() { containers++; }
+    void OnArrayEnd() {}
+    void OnKey(std::string_view) {}
+    void OnString(std::string_view) {}
+    void OnNumber(double) {}
+    void OnBool(bool) {}
+    void OnNull() {}
+  };
+
+  /// `count` arrays nested `depth` deep, side by side in one outer array.
+  std::string GenerateChains(const std::size_t count, const std::size_t depth)
+  {
+    std::string result = "[";
+    for (std::size_t i = 0; i < count; i++)
+    {
+      if (i != 0) result += ',';
+      result.append(depth, '[');
+      result += std::to_string(i);
+      result.append(depth, ']');
+    }
+    result += "]";
+    return result;
+  }
+
+  /// One flat array of `count` integers.
+  std::string GenerateWide(const std::size_t count)
+  {
+    std::string result = "[";
+    for (std::size_t i = 0; i < count; i++)
+    {
+      if (i != 0) result += ", ";
+      result += std::to_string(i * 7919 % 1000003);
+    }
+    result += "]";
+    return result;
+  }
+
+  /// Parse `source` with `parse` and return the error it throws, or an empty string.
+  template <typename Parse>
+  std::string ErrorOf(Parse&& parse)
+  {
+    try
+    {
+      parse();
+    }
+    catch (const std::runtime_error& error)
+    {
+      return error.what();
+    }
+    return {};
+  }
+}
+
+/**
+ * Runs every parser and writer on deep and wide documents, then feeds every parser input nested
+ * far beyond the default limit, which must be rejected with an exception rather than a crash,
+ * and parses and writes it once more with the limit raised.
+ *
+ * None of them recurses per level, so what depth costs shows in each row across the corpora.
+ * Rows of different parsers are not like for like: a JSONValue tree makes a heap allocation for
+ * every container, which the arena document, the tape and the SAX parse do not.
+ */
+void Bench::RunDepthBench()
+{
+  std::printf("\n--- Parsing and writing deep and wide documents ---\n");
+
+  struct Corpus
+  {
+    const char* name;
+    std::string source;
+  };
+  const Corpus corpora[] = {
+    {"deep (trees 100 levels deep)", GenerateDeep(2000, 100)},
+    {"chains (arrays 1000 levels deep)", GenerateChains(2000, 1000)},
+    {"wide (one array of integers)", GenerateWide(500000)},
+    {"records (array of objects)", GenerateRecords(20000)},
+  };
+
+  for (const Corpus& corpus : corpora)
+  {
+    const std::string& source = corpus.source;
+    std::printf("%s, %zu bytes:\n", corpus.name, source.size());
+
+    const double parse = Measure([&source]() { DoNotOptimize(JSON::Parse(source)); }, 5);
+    Report("  JSON::Parse, JSONValue tree", source.size(), parse);
+
+    const double document = Measure([&source]() { DoNotOptimize(JSON::ParseDocument(source).Root()); }, 5);
+    Report("  JSON::ParseDocument, arena", source.size(), document);
+
+    const double tape = Measure([&source]() { DoNotOptimize(JSON::ParseTape(source).Size()); }, 5);
+    Report("  JSON::ParseTape", source.size(), tape);
+
+    const double sax = Measure([&source]()
+    {
+      ContainerCount handler;
+      SAXParser<ContainerCount>::Parse(source, handler);
+      DoNotOptimize(handler.containers);
+    }, 5);
+    Report("  SAXParser, no output", source.size(), sax);
+
+    const JSONValue value = JSON::Parse(source);
+    const JSONDocument parsed = JSON::ParseDocument(source);
+    std::string buffer;
+    buffer.reserve(source.size() * 2);
+
+    const double writeValue = Measure([&]()
+    {
+      buffer.clear();
+      JSONWriter(buffer).Write(value);
+      DoNotOptimize(buffer.data());
+    }, 5);
+    Report("  JSONWriter, JSONValue", buffer.size(), writeValue);
+
+    const double writeNode = Measure([&]()
+    {
+      buffer.clear();
+      JSONWriter(buffer).Write(parsed.Root());
+      DoNotOptimize(buffer.data());
+    }, 5);
+    Report("  JSONWriter, JSONNode", buffer.size(), writeNode);
+  }
+
+  constexpr std::size_t hostileDepth = 100000;
+  std::string hostile(hostileDepth, '[');
+  hostile.append(hostileDepth, ']');
+  std::printf("%zu nested arrays, default limit of %zu:\n", hostileDepth, ParseOptions::DefaultMaxDepth);
+
+  const std::string parseError = ErrorOf([&hostile]() { DoNotOptimize(JSON::Parse(hostile)); });
+  const std::string documentError = ErrorOf([&hostile]() { DoNotOptimize(JSON::ParseDocument(hostile).Root()); });
+  const std::string tapeError = ErrorOf([&hostile]() { DoNotOptimize(JSON::ParseTape(hostile).Size()); });
+  const std::string saxError = ErrorOf([&hostile]()
+  {
+    ContainerCount handler;
+    SAXParser<ContainerCount>::Parse(hostile, handler);
+  });
+  const std::string streamError = ErrorOf([&hostile]()
+  {
+    JSONStreamParser parser;
+    for (std::size_t i = 0; i < hostile.size(); i += 4096) parser.Feed(std::string_view(hostile).substr(i, 4096));
+    parser.Finish();
+  });
+  std::printf("  JSON::Parse: %s\n", parseError.c_str());
+  std::printf("  JSON::ParseDocument: %s\n", documentError.c_str());
+  std::printf("  JSON::ParseTape: %s\n", tapeError.c_str());
+  std::printf("  SAXParser: %s\n", saxError.c_str());
+  std::printf("  JSONStreamParser: %s\n", streamError.c_str());
+  if (parseError.empty() || documentError.empty() || tapeError.empty() || saxError.empty() || streamError.empty())
+  {
+    Unexpected("input beyond the limit was accepted");
+  }
+
+  // With the limit raised, every parser and writer takes the same input.
+  ParseOptions options;
+  options.maxDepth = hostileDepth;
+  const double deepParse = Measure([&]() { DoNotOptimize(JSON::Parse(hostile, options)); }, 3);
+  Report("  JSON::Parse, maxDepth raised", hostile.size(), deepParse);
+  const double deepDocument = Measure([&]() { DoNotOptimize(JSON::ParseDocument(hostile, options).Root()); }, 3);
+  Report("  JSON::ParseDocument, maxDepth raised", hostile.size(), deepDocument);
+  const double deepTape = Measure([&]() { DoNotOptimize(JSON::ParseTape(hostile, options).Size()); }, 3);
+  Report("  JSON::ParseTape, maxDepth raised", hostile.size(), deepTape);
+  const double deepSax = Measure([&]()
+  {
+    ContainerCount handler;
+    SAXParser<ContainerCount>::Parse(hostile, handler, options);
+    DoNotOptimize(handler.containers);
+  }, 3);
+  Report("  SAXParser, maxDepth raised", hostile.size(), deepSax);
+  const double deepStream = Measure([&]()
+  {
+    JSONStreamParser parser(options);
+    for (std::size_t i = 0; i < hostile.size(); i += 4096) parser.Feed(std::string_view(hostile).substr(i, 4096));
+    parser.Finish();
+  }, 3);
+  Report("  JSONStreamParser, maxDepth raised", hostile.size(), deepStream);
+
+  const JSONValue deep = JSON::Parse(hostile, options);
+  const JSONDocument deepNodes = JSON::ParseDocument(hostile, options);
+  std::string written;
+  const double deepWrite = Measure([&]()
+  {
+    written.clear();
+    JSONWriter(written).Write(deep);
+  }, 3);
+  Report("  JSONWriter, JSONValue", written.size(), deepWrite);
+  if (written.size() != hostile.size()) Unexpected("the deep value was not written back in full");
+
+  const double deepWriteNode = Measure([&]()
+  {
+    written.clear();
+    JSONWriter(written).Write(deepNodes.Root());
+  }, 3);
+  Report("  JSONWriter, JSONNode", written.size(), deepWriteNode);
+  if (written.size() != hostile.size()) Unexpected("the deep document was not written back in full");
+
+  const double deepCopy = Measure([&]() { DoNotOptimize(JSONValue(deep)); }, 3);
+  Report("  JSONValue copy + free", hostile.size(), deepCopy);
+  const double deepConvert = Measure([&]() { DoNotOptimize(deepNodes.Root().ToJSONValue()); }, 3);
+  Report("  JSONNode::ToJSONValue + free", hostile.size(), deepConvert);
+}
@@ -0,0 +1,83 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+
+/**
+ * Compares building and destroying a JSONValue tree with an arena-backed JSONDocument,
+ * and shows that the document's allocation count does not grow with its size.
+ * The zero-copy run keeps unescaped strings as views into the source.
+ */
+void Bench::RunDocumentBench()
+{
+  std::printf("\n--- JSONValue tree vs. arena JSONDocument ---\n");
+
+  for (const std::size_t records : {100, 10000, 100000})
+  {
+    const std::string source = GenerateRecords(records);
+
+    std::size_t treeAllocations = 0;
+    const double tree = Measure([&]()
+    {
+      const std::size_t before = AllocationCount();
+      {
+        const JSONValue value = JSON::Parse(source);
+        DoNotOptimize(value);
+      }
+      treeAllocations = AllocationCount() - before;
+    }, 3);
+
+    // Arena chunks come from malloc and bypass the operator new hook, so they are added on top.
+    std::size_t documentAllocations = 0;
+    const double document = Measure([&]()
+    {
+      const std::size_t before = AllocationCount();
+      std::size_t chunks = 0;
+      {
+        const JSONDocument value = JSON::ParseDocument(source);
+        DoNotOptimize(value.Root());
+        chunks = value.ArenaAllocationCount();
+      }
+      documentAllocations = AllocationCount() - before + chunks;
+    }, 3);
+
+    std::size_t zeroCopyBytes = 0;
+    const double zeroCopy = Measure([&]()
+    {
+      const JSONDocument value = JSON::ParseDocument(source, ParseOptions{.zeroCopyStrings = true});
+      DoNotOptimize(value.Root());
+      zeroCopyBytes = value.BytesUsed();
+    }, 3);
+
+    const std::size_t documentBytes = JSON::ParseDocument(source).BytesUsed();
+
+    std::printf("%zu records:\n", records);
+    Report("  JSONValue parse + free", source.size(), tree);
+    Report("  JSONDocument parse + free", source.size(), document);
+    Report("  JSONDocument zero-copy strings", source.size(), zeroCopy);
+    std::printf("  heap allocations per parse + free: tree %zu, document %zu\n", treeAllocations, documentAllocations);
+    std::printf("  arena bytes used: copied strings %zu, zero-copy %zu\n", documentBytes, zeroCopyBytes);
+
+    // Lookups by string compare keys character by character, interned handles compare pointers.
+    const JSONDocument parsed = JSON::ParseDocument(source);
+    const JSONKey scoreKey = parsed.Key("score");
+    const double byString = Measure([&]()
+    {
+      double sum = 0;
+      for (const JSONNode& record : parsed.Root().Elements()) sum += record["score"].AsDouble();
+      DoNotOptimize(sum);
+    }, 5);
+    const double byKey = Measure([&]()
+    {
+      double sum = 0;
+      for (const JSONNode& record : parsed.Root().Elements()) sum += record[scoreKey].AsDouble();
+      DoNotOptimize(sum);
+    }, 5);
+    std::printf("  %zu distinct keys in %zu bytes; lookup by string %.1f ns, by JSONKey %.1f ns\n",
+                parsed.Keys().Size(), parsed.Keys().BytesUsed(),
+                byString / static_cast<double>(records) * 1e9, byKey / static_cast<double>(records) * 1e9);
+  }
+}
@@ -0,0 +1,43 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "Lexer.h"
+#include "StructuralScanner.h"
+#include <cstdio>
+
+/**
+ * Measures the raw throughput of every stage-1 kernel and of the full Lexer.
+ */
+void Bench::RunLexerBench()
+{
+  const std::string source = GenerateRecords(50000);
+  std::printf("\n--- Lexer (%zu bytes, active kernel: %s) ---\n", source.size(),
+              StructuralScanner::Name(StructuralScanner::Select()));
+
+  const StructuralScanner::Kernel kernels[] = {
+    &StructuralScanner::ScanScalar, &StructuralScanner::ScanSSE42, &StructuralScanner::ScanAVX2
+  };
+
+  for (const StructuralScanner::Kernel kernel : kernels)
+  {
+    const std::size_t blocks = source.size() / StructuralScanner::BlockSize;
+    const double seconds = Measure([&]()
+    {
+      uint64_t structurals = 0;
+      for (std::size_t i = 0; i < blocks; i++)
+      {
+        structurals += kernel(source.data() + i * StructuralScanner::BlockSize).structural;
+      }
+      DoNotOptimize(structurals);
+    }, 10);
+    Report(std::string("scan kernel ") + StructuralScanner::Name(kernel), blocks * StructuralScanner::BlockSize, seconds);
+  }
+
+  const double tokenize = Measure([&source]()
+  {
+    DoNotOptimize(Lexer::Tokenize(source));
+  }, 5);
+  Report("Lexer::Tokenize", source.size(), tokenize);
+}
@@ -0,0 +1,36 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+#include <thread>
+
+/**
+ * Parses a JSON Lines log with 1 to N threads, N being the hardware thread count (at least 4).
+ */
+void Bench::RunLinesBench()
+{
+  // One record per line: the generated array without its brackets, split at the record separators.
+  std::string source = GenerateRecords(100000);
+  source = source.substr(1, source.size() - 2);
+  for (std::size_t i = source.find(",\n"); i != std::string::npos; i = source.find(",\n", i)) source.erase(i, 1);
+
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  const unsigned int maximum = hardware < 4 ? 4 : hardware;
+  std::printf("\n--- JSON::ParseLines (%zu bytes, %u hardware threads) ---\n", source.size(), hardware);
+
+  double single = 0;
+  for (unsigned int threads = 1; threads <= maximum; threads *= 2)
+  {
+    const double seconds = Measure([&source, threads]()
+    {
+      DoNotOptimize(JSON::ParseLines(source, threads));
+    }, 3);
+    if (threads == 1) single = seconds;
+
+    Report("ParseLines, " + std::to_string(threads) + " thread(s)", source.size(), seconds);
+    std::printf("  speedup over 1 thread: %.2fx\n", single / seconds);
+  }
+}
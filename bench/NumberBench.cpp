@@ -0,0 +1,110 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+  // 64-bit IDs, most of them above 2^53 where a double can no longer hold them exactly.
+  std::string GenerateIds(const std::size_t count)
+  {
+    std::string result = "[";
+    uint64_t state = 88172645463325252ull;
+    for (std::size_t i = 0; i < count; i++)
+    {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      if (i != 0) result += ",";
+      result += std::to_string(state >> (i % 4 == 0 ? 1 : 0));
+    }
+    return result + "]";
+  }
+
+  // Coordinate pairs with full double precision, like the polygons in GeoJSON files.
+  std::string GenerateCoordinates(const std::size_t count)
+  {
+    std::string result = "[";
+    unsigned int state = 12345;
+    auto next = [&state]() { state = state * 1103515245u + 12345u; return static_cast<double>(state >> 8) / 16777216.0; };
+
+    char buffer[64];
+    for (std::size_t i = 0; i < count; i++)
+    {
+      if (i != 0) result += ",";
+      std::snprintf(buffer, sizeof(buffer), "[%.15f,%.15f]", next() * 360.0 - 180.0, next() * 180.0 - 90.0);
+      result += buffer;
+    }
+    return result + "]";
+  }
+}
+
+/**
+ * Measures number conversion on number-heavy input: converting the lexed tokens with the old
+ * std::stod call against Parser::ParseNumber, and the full parse into both tree types.
+ */
+void Bench::RunNumberBench()
+{
+  std::printf("\n--- Number parsing ---\n");
+
+  const struct
+  {
+    const char* name;
+    std::string source;
+  } corpora[] = {
+    {"64-bit integer ids", GenerateIds(500000)},
+    {"double coordinates", GenerateCoordinates(250000)},
+  };
+
+  for (const auto& [name, source] : corpora)
+  {
+    std::vector<Token> numbers;
+    Lexer lexer(source);
+    for (Token token = lexer.NextToken(); token.type != TokenType::END_OF_FILE; token = lexer.NextToken())
+    {
+      if (token.type == TokenType::INT || token.type == TokenType::DOUBLE) numbers.push_back(token);
+    }
+
+    std::size_t numberBytes = 0;
+    for (const Token& token : numbers) numberBytes += token.value.size();
+
+    const double stod = Measure([&numbers]()
+    {
+      double sum = 0;
+      for (const Token& token : numbers) sum += std::stod(std::string(token.value));
+      DoNotOptimize(sum);
+    }, 5);
+
+    const double fromChars = Measure([&numbers]()
+    {
+      uint64_t sum = 0;
+      for (const Token& token : numbers) sum += Parser::ParseNumber(token).unsignedInteger;
+      DoNotOptimize(sum);
+    }, 5);
+
+    const double tree = Measure([&source]() { DoNotOptimize(JSON::Parse(source)); }, 3);
+    const double document = Measure([&source]() { DoNotOptimize(JSON::ParseDocument(source).Root()); }, 3);
+
+    // Round-trip the first number as written to show whether it kept its precision.
+    const JSONValue parsed = JSON::Parse(source);
+    const JSONValue& first = parsed[0].IsJSONArray() ? parsed[0][0] : parsed[0];
+    const std::string exact(numbers.front().value);
+    char kept[64];
+    if (first.IsDouble()) std::snprintf(kept, sizeof(kept), "%.17g", first.AsDouble());
+    else std::snprintf(kept, sizeof(kept), "%s", first.ToString().c_str());
+
+    std::printf("%s (%zu numbers):\n", name, numbers.size());
+    Report("  std::stod(std::string(token))", numberBytes, stod);
+    Report("  Parser::ParseNumber", numberBytes, fromChars);
+    Report("  JSON::Parse", source.size(), tree);
+    Report("  JSON::ParseDocument", source.size(), document);
+    std::printf("  first value %s, parsed back as %s\n", exact.c_str(), kept);
+  }
+}
@@ -0,0 +1,66 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+#include <map>
+
+/**
+ * Compares key lookup and member iteration of JSONObject against the std::map
+ * it replaced, for objects below and above the hash index threshold.
+ */
+void Bench::RunObjectBench()
+{
+  std::printf("\n--- JSONObject vs. std::map ---\n");
+
+  for (const std::size_t members : {4, 16, 64, 1024})
+  {
+    std::vector<std::string> keys;
+    std::map<std::string, JSONValue> map;
+    JSONObject object;
+    for (std::size_t i = 0; i < members; i++)
+    {
+      keys.push_back("field_" + std::to_string(i * 7919 % 10007));
+      map[keys.back()] = JSONValue{static_cast<double>(i)};
+      object[keys.back()] = JSONValue{static_cast<double>(i)};
+    }
+
+    const std::size_t rounds = 1000000 / members;
+    const double mapLookup = Measure([&]()
+    {
+      double sum = 0;
+      for (std::size_t r = 0; r < rounds; r++)
+        for (const std::string& key : keys) sum += map.find(key)->second.AsDouble();
+      DoNotOptimize(sum);
+    }, 3);
+    const double objectLookup = Measure([&]()
+    {
+      double sum = 0;
+      for (std::size_t r = 0; r < rounds; r++)
+        for (const std::string& key : keys) sum += object.find(key)->Value().AsDouble();
+      DoNotOptimize(sum);
+    }, 3);
+
+    const double mapIterate = Measure([&]()
+    {
+      double sum = 0;
+      for (std::size_t r = 0; r < rounds; r++)
+        for (const auto& [key, value] : map) sum += value.AsDouble();
+      DoNotOptimize(sum);
+    }, 3);
+    const double objectIterate = Measure([&]()
+    {
+      double sum = 0;
+      for (std::size_t r = 0; r < rounds; r++)
+        for (const auto& [key, value] : object) sum += value.AsDouble();
+      DoNotOptimize(sum);
+    }, 3);
+
+    const double operations = static_cast<double>(rounds * members);
+    std::printf("%4zu members: lookup map %6.1f ns, object %6.1f ns | iterate map %5.2f ns, object %5.2f ns\n",
+                members, mapLookup / operations * 1e9, objectLookup / operations * 1e9,
+                mapIterate / operations * 1e9, objectIterate / operations * 1e9);
+  }
+}
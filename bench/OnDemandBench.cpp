@@ -0,0 +1,32 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+
+/**
+ * Reads three fields out of a ~50 KB message, once by parsing the whole message
+ * into a JSONValue and once through a JSONCursor that skips the payload.
+ */
+void Bench::RunOnDemandBench()
+{
+  const std::string message = R"({"id": 4711, "payload": )" + GenerateRecords(330) +
+                              R"(, "meta": {"user": "alice", "region": "eu"}, "status": "ok"})";
+  std::printf("\n--- On-demand navigation (%zu byte message, 3 fields) ---\n", message.size());
+
+  const double full = Measure([&message]()
+  {
+    const JSONValue root = JSON::Parse(message);
+    DoNotOptimize(root["id"].AsInt() + root["meta"]["user"].AsString().size() + root["status"].AsString().size());
+  }, 50);
+  Report("JSON::Parse + 3 lookups", message.size(), full);
+
+  const double onDemand = Measure([&message]()
+  {
+    const JSONCursor root = JSON::ParseOnDemand(message);
+    DoNotOptimize(root["id"].AsInt() + root["meta"]["user"].AsString().size() + root["status"].AsString().size());
+  }, 50);
+  Report("JSON::ParseOnDemand + 3 lookups", message.size(), onDemand);
+}
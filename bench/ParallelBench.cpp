@@ -0,0 +1,36 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+#include <thread>
+
+/**
+ * Parses one large top-level array sequentially and with JSON::ParseParallel on 1 to N threads.
+ */
+void Bench::RunParallelBench()
+{
+  const std::string source = GenerateRecords(100000);
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  const unsigned int maximum = hardware < 4 ? 4 : hardware;
+  std::printf("\n--- JSON::ParseParallel (%zu bytes, %u hardware threads) ---\n", source.size(), hardware);
+
+  const double sequential = Measure([&source]()
+  {
+    DoNotOptimize(JSON::Parse(source));
+  }, 3);
+  Report("JSON::Parse", source.size(), sequential);
+
+  for (unsigned int threads = 1; threads <= maximum; threads *= 2)
+  {
+    const double seconds = Measure([&source, threads]()
+    {
+      DoNotOptimize(JSON::ParseParallel(source, threads));
+    }, 3);
+
+    Report("ParseParallel, " + std::to_string(threads) + " thread(s)", source.size(), seconds);
+    std::printf("  speedup over JSON::Parse: %.2fx\n", sequential / seconds);
+  }
+}
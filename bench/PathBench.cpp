@@ -0,0 +1,57 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "JSONPath.h"
+#include <cstdio>
+
+/**
+ * Pulls one deep field out of a parsed tree by chaining operator[] and through a compiled
+ * JSONPath, then extracts a whole column, from the tree and straight from the text.
+ */
+void Bench::RunPathBench()
+{
+  const std::string message = R"({"id": 4711, "payload": {"items": )" + GenerateRecords(330) +
+                              R"(}, "meta": {"user": "alice", "region": "eu"}, "status": "ok"})";
+  std::printf("\n--- JSONPath (%zu byte message) ---\n", message.size());
+
+  const JSONValue root = JSON::Parse(message);
+  constexpr int lookups = 100000;
+
+  const double chained = Measure([&root]()
+  {
+    for (int i = 0; i < lookups; i++) DoNotOptimize(root["payload"]["items"][3]["score"].AsDouble());
+  }, 5);
+  const JSONPath score("/payload/items/3/score");
+  const double compiled = Measure([&root, &score]()
+  {
+    for (int i = 0; i < lookups; i++) DoNotOptimize(score.Get(root).AsDouble());
+  }, 5);
+  std::printf("%-40s %10.1f ns per lookup\n", "operator[] chain", chained * 1e9 / lookups);
+  std::printf("%-40s %10.1f ns per lookup\n", "compiled JSON Pointer", compiled * 1e9 / lookups);
+
+  const JSONPath column("$.payload.items[*].score");
+  const double tree = Measure([&root, &column]()
+  {
+    double total = 0;
+    column.Select(root, [&total](const JSONValue& value) { total += value.AsDouble(); });
+    DoNotOptimize(total);
+  }, 20);
+  const double text = Measure([&message, &column]()
+  {
+    double total = 0;
+    column.Select(message, [&total](const JSONCursor& value) { total += value.AsDouble(); });
+    DoNotOptimize(total);
+  }, 20);
+  const double parseAndTree = Measure([&message, &column]()
+  {
+    double total = 0;
+    column.Select(JSON::Parse(message), [&total](const JSONValue& value) { total += value.AsDouble(); });
+    DoNotOptimize(total);
+  }, 20);
+  Report("column from parsed tree", message.size(), tree);
+  Report("column via JSON::Parse + tree", message.size(), parseAndTree);
+  Report("column straight from text", message.size(), text);
+}
@@ -0,0 +1,96 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSONParser.h"
+#include <cstdio>
+#include <vector>
+
+/**
+ * Parses a stream of small messages, once with a fresh output per message and once with a
+ * long-lived JSONParser writing into the same output. After a warm-up pass the reused
+ * parser should make no heap allocation at all, which test/AllocationTest.cpp checks; arena
+ * chunks come from malloc, so they are counted through the document rather than the
+ * operator new hook.
+ */
+void Bench::RunReuseBench()
+{
+  std::printf("\n--- Fresh output per message vs. reused JSONParser ---\n");
+
+  std::vector<std::string> messages;
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; i < 2000; i++)
+  {
+    messages.push_back(GenerateRecords(1 + i % 4));
+    bytes += messages.back().size();
+  }
+  const auto perMessage = [&messages](const std::size_t count) { return static_cast<double>(count) / static_cast<double>(messages.size()); };
+
+  std::size_t freshAllocations = 0;
+  const double fresh = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    std::size_t chunks = 0;
+    for (const std::string& message : messages)
+    {
+      const JSONDocument document = JSON::ParseDocument(message);
+      DoNotOptimize(document.Root());
+      chunks += document.ArenaAllocationCount();
+    }
+    freshAllocations = AllocationCount() - before + chunks;
+  }, 5);
+
+  JSONParser parser;
+  JSONDocument document;
+  for (const std::string& message : messages) parser.Parse(message, document); // Warm up
+
+  std::size_t reusedAllocations = 0;
+  const double reused = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    const std::size_t chunksBefore = document.ArenaAllocationCount();
+    for (const std::string& message : messages)
+    {
+      parser.Parse(message, document);
+      DoNotOptimize(document.Root());
+    }
+    reusedAllocations = AllocationCount() - before + document.ArenaAllocationCount() - chunksBefore;
+  }, 5);
+
+  std::size_t freshTapeAllocations = 0;
+  const double freshTape = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    for (const std::string& message : messages)
+    {
+      const JSONTape tape = JSON::ParseTape(message);
+      DoNotOptimize(tape.Size());
+    }
+    freshTapeAllocations = AllocationCount() - before;
+  }, 5);
+
+  JSONTape tape;
+  for (const std::string& message : messages) parser.Parse(message, tape); // Warm up
+
+  std::size_t reusedTapeAllocations = 0;
+  const double reusedTape = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    for (const std::string& message : messages)
+    {
+      parser.Parse(message, tape);
+      DoNotOptimize(tape.Size());
+    }
+    reusedTapeAllocations = AllocationCount() - before;
+  }, 5);
+
+  std::printf("%zu messages, %zu bytes each on average:\n", messages.size(), bytes / messages.size());
+  Report("  JSON::ParseDocument per message", bytes, fresh);
+  Report("  JSONParser into one JSONDocument", bytes, reused);
+  Report("  JSON::ParseTape per message", bytes, freshTape);
+  Report("  JSONParser onto one JSONTape", bytes, reusedTape);
+  std::printf("  heap allocations per message: document %.2f fresh, %.2f reused; tape %.2f fresh, %.2f reused\n",
+              perMessage(freshAllocations), perMessage(reusedAllocations),
+              perMessage(freshTapeAllocations), perMessage(reusedTapeAllocations));
+}
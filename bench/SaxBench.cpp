@@ -0,0 +1,54 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "JSONSax.h"
+#include <cstdio>
+
+namespace
+{
+  /// Sums every "score" member, the kind of aggregation the SAX interface is meant for.
+  struct ScoreSum
+  {
+    double sum = 0;
+    bool nextIsScore = false;
+
+    void OnObjectStart() {}
+    void OnObjectEnd() {}
+    void OnArrayStart() {}
+    void OnArrayEnd() {}
+    void OnKey(const std::string_view key) { nextIsScore = key == "score"; }
+    void OnString(std::string_view) { nextIsScore = false; }
+    void OnNumber(const double number) { if (nextIsScore) sum += number; nextIsScore = false; }
+    void OnBool(bool) { nextIsScore = false; }
+    void OnNull() { nextIsScore = false; }
+  };
+}
+
+/**
+ * Aggregates one field over every record, with a SAX handler and with a JSONValue tree.
+ */
+void Bench::RunSaxBench()
+{
+  const std::string source = GenerateRecords(50000);
+  std::printf("\n--- SAX vs. DOM aggregation (%zu bytes) ---\n", source.size());
+
+  const double dom = Measure([&source]()
+  {
+    const JSONValue root = JSON::Parse(source);
+    double sum = 0;
+    for (const JSONValue& record : root.AsArray()) sum += record["score"].AsDouble();
+    DoNotOptimize(sum);
+  }, 5);
+  Report("JSON::Parse + walk", source.size(), dom);
+
+  const double sax = Measure([&source]()
+  {
+    ScoreSum handler;
+    SAXParser<ScoreSum>::Parse(source, handler);
+    DoNotOptimize(handler.sum);
+  }, 5);
+  Report("SAXParser", source.size(), sax);
+}
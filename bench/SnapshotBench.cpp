@@ -0,0 +1,55 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * Startup cost of a large configuration-style file: parsing the text on every start
+ * versus opening a binary snapshot of it and reading a few values.
+ */
+void Bench::RunSnapshotBench()
+{
+  const std::string source = GenerateRecords(100000);
+  const std::filesystem::path directory = std::filesystem::temp_directory_path();
+  const std::string textPath = (directory / "JSONParserBench.json").string();
+  const std::string binaryPath = (directory / "JSONParserBench.snapshot").string();
+  std::ofstream(textPath, std::ios::binary) << source;
+
+  const auto start = std::chrono::steady_clock::now();
+  JSON::SaveBinary(binaryPath, JSON::LoadFromFile(textPath));
+  const std::chrono::duration<double> save = std::chrono::steady_clock::now() - start;
+  const auto binarySize = static_cast<std::size_t>(std::filesystem::file_size(binaryPath));
+
+  std::printf("\n--- Binary snapshot (%zu byte text, %zu byte snapshot, converted in %.1f ms) ---\n",
+              source.size(), binarySize, save.count() * 1e3);
+
+  const double text = Measure([&textPath]()
+  {
+    const JSONValue root = JSON::LoadFromFile(textPath);
+    DoNotOptimize(root[99999]["name"].AsString().size() + root[500]["tags"][1].AsString().size());
+  }, 3);
+  Report("LoadFromFile + 2 lookups", source.size(), text);
+
+  const double binary = Measure([&binaryPath]()
+  {
+    const JSONSnapshot snapshot = JSON::LoadBinary(binaryPath);
+    const JSONSnapshotValue root = snapshot.Root();
+    DoNotOptimize(root[99999]["name"].AsString().size() + root[500]["tags"][1].AsString().size());
+  }, 20);
+  Report("LoadBinary + 2 lookups", source.size(), binary);
+
+  const double full = Measure([&binaryPath]()
+  {
+    DoNotOptimize(JSON::LoadBinary(binaryPath).Root().ToJSONValue());
+  }, 3);
+  Report("LoadBinary + ToJSONValue", source.size(), full);
+
+  std::filesystem::remove(textPath);
+  std::filesystem::remove(binaryPath);
+}
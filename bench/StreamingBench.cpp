@@ -0,0 +1,33 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <cstdio>
+
+/**
+ * Compares the two-stage path (Tokenize into a vector, then parse the vector)
+ * against the fused path where the parser pulls tokens from the Lexer on demand.
+ */
+void Bench::RunStreamingBench()
+{
+  const std::string source = GenerateRecords(50000);
+  std::printf("\n--- Streaming vs. two-stage parse (%zu bytes) ---\n", source.size());
+
+  const double twoStage = Measure([&source]()
+  {
+    const auto tokens = Lexer::Tokenize(source);
+    DoNotOptimize(Parser::Parse(tokens));
+  }, 5);
+  Report("two-stage (Tokenize + Parse)", source.size(), twoStage);
+
+  const double fused = Measure([&source]()
+  {
+    DoNotOptimize(Parser::Parse(std::string_view(source)));
+  }, 5);
+  Report("fused (Lexer on demand)", source.size(), fused);
+
+  std::printf("speedup: %.2fx\n", twoStage / fused);
+}
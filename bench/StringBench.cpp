@@ -0,0 +1,112 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "JSONWriter.h"
+#include "StringScanner.h"
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+  /// Log records whose messages are long and contain the odd escape, quote or emoji.
+  std::string GenerateLogs(const std::size_t count)
+  {
+    static const char* const messages[] = {
+      R"(Request completed in 12ms for user 48213, cache hit ratio 0.93, upstream=api-eu-west-1, retries=0)",
+      R"(Failed to open \"/var/lib/service/state.db\": permission denied (errno 13), falling back to read-only mode)",
+      R"(Stack trace:\n  at Handler.process (handler.js:118)\n  at Queue.drain (queue.js:42)\n  at Timer.tick (timer.js:7))",
+      R"(User comment: été à Zürich was great 😀, would visit again, rating 5 of 5 stars)",
+    };
+
+    std::string result = "[";
+    for (std::size_t i = 0; i < count; i++)
+    {
+      if (i != 0) result += ",\n";
+      result += R"({"level": "info", "service": "gateway", "message": ")";
+      result += messages[i % 4];
+      result += R"("})";
+    }
+    return result + "]";
+  }
+}
+
+/**
+ * Measures the string kernels on their own and the parse and serialize paths on a
+ * string-heavy log corpus.
+ */
+void Bench::RunStringBench()
+{
+  std::printf("\n--- Strings (kernels: %s) ---\n", StringScanner::Select().name);
+
+  const std::string source = GenerateLogs(50000);
+
+  // Search a long run without matches, as inside one big unescaped string.
+  const std::string plain(1 << 20, 'x');
+  const struct
+  {
+    const char* name;
+    StringScanner::Kernel kernel;
+  } kernels[] = {
+    {"  find backslash, scalar", &StringScanner::FindBackslashScalar},
+    {"  find backslash, sse2", &StringScanner::FindBackslashSSE2},
+    {"  find backslash, avx2", &StringScanner::FindBackslashAVX2},
+    {"  find escapable, scalar", &StringScanner::FindEscapableScalar},
+    {"  find escapable, sse2", &StringScanner::FindEscapableSSE2},
+    {"  find escapable, avx2", &StringScanner::FindEscapableAVX2},
+  };
+  for (const auto& [name, kernel] : kernels)
+  {
+    if (kernel == &StringScanner::FindBackslashAVX2 || kernel == &StringScanner::FindEscapableAVX2)
+    {
+      if (StringScanner::Select().findBackslash != &StringScanner::FindBackslashAVX2) continue;
+    }
+    const double seconds = Measure([&]() { DoNotOptimize(kernel(plain.data(), plain.size())); }, 20);
+    Report(name, plain.size(), seconds);
+  }
+
+  // Most keys and values are short, so the per-call cost matters more than the bulk rate:
+  // search 8 to 47 byte runs one call at a time, through the dispatcher as the writer does.
+  constexpr std::size_t shortRuns = 100000;
+  std::vector<std::size_t> offsets;
+  offsets.reserve(shortRuns + 1);
+  offsets.push_back(0);
+  for (std::size_t i = 0; i < shortRuns; i++) offsets.push_back(offsets.back() + 8 + (i * 7) % 40);
+  const std::string runs(offsets.back(), 'x');
+  const struct
+  {
+    const char* name;
+    StringScanner::Kernel kernel;
+  } shortKernels[] = {
+    {"  find escapable, scalar, short runs", &StringScanner::FindEscapableScalar},
+    {"  find escapable, sse2, short runs", &StringScanner::FindEscapableSSE2},
+    {"  find escapable, dispatched, short runs", &StringScanner::FindEscapable},
+  };
+  for (const auto& [name, kernel] : shortKernels)
+  {
+    const double seconds = Measure([&]()
+    {
+      std::size_t found = 0;
+      for (std::size_t i = 0; i < shortRuns; i++) found += kernel(runs.data() + offsets[i], offsets[i + 1] - offsets[i]);
+      DoNotOptimize(found);
+    }, 20);
+    Report(name, runs.size(), seconds);
+    std::printf("    %.1f ns per call\n", seconds * 1e9 / shortRuns);
+  }
+
+  const double parse = Measure([&source]() { DoNotOptimize(JSON::Parse(source)); }, 5);
+  const JSONValue value = JSON::Parse(source);
+
+  std::string buffer;
+  const double write = Measure([&]()
+  {
+    buffer.clear();
+    JSONWriter(buffer).Write(value);
+    DoNotOptimize(buffer);
+  }, 5);
+
+  Report("  JSON::Parse log records", source.size(), parse);
+  Report("  JSONWriter log records", buffer.size(), write);
+}
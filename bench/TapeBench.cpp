@@ -0,0 +1,96 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include <cstdio>
+
+namespace
+{
+  /// Visit every value of a tree and count them, so a full traversal cannot be optimised away.
+  std::size_t CountValues(const JSONValue& value)
+  {
+    std::size_t count = 1;
+    if (value.IsJSONArray())
+    {
+      for (const JSONValue& element : value.AsArray()) count += CountValues(element);
+    }
+    else if (value.IsJSONObject())
+    {
+      for (const auto& member : value.AsObject()) count += CountValues(member.Value());
+    }
+    return count;
+  }
+
+  std::size_t CountValues(const JSONElement element)
+  {
+    std::size_t count = 1;
+    if (element.IsJSONArray())
+    {
+      for (const JSONElement child : element.Elements()) count += CountValues(child);
+    }
+    else if (element.IsJSONObject())
+    {
+      for (const auto& member : element.Members()) count += CountValues(member.value);
+    }
+    return count;
+  }
+}
+
+/**
+ * Compares the JSONValue tree with the tape: parsing, a full traversal, and a key lookup in
+ * every record.
+ */
+void Bench::RunTapeBench()
+{
+  std::printf("\n--- JSONValue tree vs. JSONTape ---\n");
+
+  for (const std::size_t records : {1000, 100000})
+  {
+    const std::string source = GenerateRecords(records);
+
+    const double treeParse = Measure([&]()
+    {
+      const JSONValue value = JSON::Parse(source);
+      DoNotOptimize(value);
+    }, 3);
+
+    const double tapeParse = Measure([&]()
+    {
+      const JSONTape tape = JSON::ParseTape(source);
+      DoNotOptimize(tape.Size());
+    }, 3);
+
+    const JSONValue tree = JSON::Parse(source);
+    const JSONTape tape = JSON::ParseTape(source);
+
+    std::size_t treeCount = 0;
+    const double treeWalk = Measure([&]() { treeCount = CountValues(tree); DoNotOptimize(treeCount); }, 5);
+    std::size_t tapeCount = 0;
+    const double tapeWalk = Measure([&]() { tapeCount = CountValues(tape.Root()); DoNotOptimize(tapeCount); }, 5);
+
+    const double treeLookup = Measure([&]()
+    {
+      double sum = 0;
+      for (const JSONValue& record : tree.AsArray()) sum += record["score"].AsDouble();
+      DoNotOptimize(sum);
+    }, 5);
+    const double tapeLookup = Measure([&]()
+    {
+      double sum = 0;
+      for (const JSONElement record : tape.Root().Elements()) sum += record["score"].AsDouble();
+      DoNotOptimize(sum);
+    }, 5);
+
+    std::printf("%zu records (%zu values):\n", records, tapeCount);
+    Report("  JSONValue parse + free", source.size(), treeParse);
+    Report("  JSONTape parse + free", source.size(), tapeParse);
+    Report("  JSONValue full traversal", source.size(), treeWalk);
+    Report("  JSONTape full traversal", source.size(), tapeWalk);
+    Report("  JSONValue lookup per record", source.size(), treeLookup);
+    Report("  JSONTape lookup per record", source.size(), tapeLookup);
+    std::printf("  tape %zu words, %zu bytes used, %zu reserved\n", tape.Size(), tape.BytesUsed(), tape.BytesAllocated());
+    if (treeCount != tapeCount) std::printf("  value count mismatch: tree %zu\n", treeCount);
+  }
+}
@@ -0,0 +1,155 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "StringScanner.h"
+#include <cstdio>
+#include <iterator>
+
+namespace
+{
+  /// Text mixing ASCII with two, three and four byte sequences, like user-generated content.
+  std::string GenerateMixedText(const std::size_t bytes)
+  {
+    static constexpr const char* pieces[] = {
+      "plain ascii words and numbers 12345 ",
+      "Grüße aus Köln, señor! ",
+      "東京都の天気は晴れです。",
+      "Привет, как дела? ",
+      "🎉🚀 party time ",
+      "naïve café crème brûlée ",
+    };
+
+    std::string text;
+    text.reserve(bytes + 64);
+    uint32_t state = 7;
+    while (text.size() < bytes)
+    {
+      state = state * 1103515245 + 12345;
+      text += pieces[(state >> 16) % std::size(pieces)];
+    }
+    return text;
+  }
+
+  /// An array of records whose "text" members hold mixed text.
+  std::string GenerateMixedRecords(const std::size_t count)
+  {
+    std::string result = "[";
+    for (std::size_t i = 0; i < count; i++)
+    {
+      if (i != 0) result += ",\n";
+      result += R"({"id": )" + std::to_string(i) + R"(, "text": ")" + GenerateMixedText(40 + i % 200) + R"(", "lang": "mixed"})";
+    }
+    result += "]";
+    return result;
+  }
+}
+
+/**
+ * Measures the UTF-8 validators on their own and fused into the parse, and checks every
+ * kernel against a set of well-formed and malformed sequences.
+ */
+void Bench::RunUTF8Bench()
+{
+  std::printf("\n--- UTF-8 validation (%s kernel selected) ---\n", StringScanner::Select().name);
+
+  struct Validator
+  {
+    const char* name;
+    StringScanner::Validator validate;
+  };
+  const Validator validators[] = {
+    {"scalar", &StringScanner::ValidUTF8Scalar},
+    {"sse2", &StringScanner::ValidUTF8SSE2},
+    {"avx2", &StringScanner::ValidUTF8AVX2},
+  };
+
+  struct Case
+  {
+    const char* bytes;
+    bool valid;
+  };
+  const Case cases[] = {
+    {"", true},
+    {"ascii only", true},
+    {"\xC3\xA9", true},                  // U+00E9
+    {"\xE2\x82\xAC", true},              // U+20AC
+    {"\xED\x9F\xBF", true},              // U+D7FF, just below the surrogates
+    {"\xEE\x80\x80", true},              // U+E000, just above them
+    {"\xF0\x9F\x8E\x89", true},          // U+1F389
+    {"\xF4\x8F\xBF\xBF", true},          // U+10FFFF
+    {"\x80", false},                     // Lone continuation byte
+    {"\xC3", false},                     // Truncated
+    {"\xC3\xA9\xA9", false},             // Continuation too many
+    {"\xC0\xAF", false},                 // Overlong '/'
+    {"\xC1\xBF", false},                 // Overlong
+    {"\xE0\x80\xAF", false},             // Overlong three bytes
+    {"\xF0\x80\x80\xAF", false},         // Overlong four bytes
+    {"\xED\xA0\x80", false},             // High surrogate U+D800
+    {"\xED\xBF\xBF", false},             // Low surrogate U+DFFF
+    {"\xF4\x90\x80\x80", false},         // U+110000
+    {"\xF5\x80\x80\x80", false},         // Lead byte past F4
+    {"\xFF", false},
+    {"\xE2\x82", false},                 // Truncated three bytes
+    {"\xF0\x9F\x8E", false},             // Truncated four bytes
+    {"\xE2\x28\xA1", false},             // ASCII inside a sequence
+  };
+
+  // Place every case at the start, across a 32-byte boundary and at the end of a longer buffer,
+  // so the tails and chunk boundaries of the vector kernels are exercised too.
+  std::size_t failures = 0;
+  for (const Validator& validator : validators)
+  {
+    for (const Case& test : cases)
+    {
+      const std::string bytes = test.bytes;
+      for (const std::size_t offset : {std::size_t{0}, std::size_t{30}, std::size_t{61}, std::size_t{64}})
+      {
+        const std::string padded = std::string(offset, 'a') + bytes + std::string(offset % 7, 'z');
+        if (validator.validate(padded.data(), padded.size()) != test.valid) failures++;
+      }
+    }
+  }
+  if (failures != 0) Unexpected(std::to_string(failures) + " kernel results disagree with the expected validity");
+
+  const std::string ascii = GenerateRecords(30000);
+  const std::string mixed = GenerateMixedText(ascii.size());
+  for (const Validator& validator : validators)
+  {
+    bool valid = true;
+    const double onAscii = Measure([&]() { valid &= validator.validate(ascii.data(), ascii.size()); }, 10);
+    const double onMixed = Measure([&]() { valid &= validator.validate(mixed.data(), mixed.size()); }, 10);
+    if (!valid) Unexpected(std::string(validator.name) + " rejected valid text");
+
+    Report(std::string("  ") + validator.name + ", ASCII", ascii.size(), onAscii);
+    Report(std::string("  ") + validator.name + ", mixed text", mixed.size(), onMixed);
+  }
+
+  ParseOptions trusted;
+  trusted.validateUTF8 = false;
+
+  const std::string twitter = GenerateTwitter(3000);
+  const std::string records = GenerateMixedRecords(20000);
+  struct Corpus
+  {
+    const char* name;
+    const std::string& source;
+  };
+  for (const Corpus& corpus : {Corpus{"twitter", twitter}, Corpus{"mixed-text records", records}})
+  {
+    const std::string& source = corpus.source;
+    std::printf("%s, %zu bytes:\n", corpus.name, source.size());
+
+    const double validated = Measure([&source]() { DoNotOptimize(JSON::Parse(source)); }, 5);
+    const double skipped = Measure([&]() { DoNotOptimize(JSON::Parse(source, trusted)); }, 5);
+    Report("  JSON::Parse, validated", source.size(), validated);
+    Report("  JSON::Parse, validateUTF8 off", source.size(), skipped);
+
+    const double document = Measure([&source]() { DoNotOptimize(JSON::ParseDocument(source).Root()); }, 5);
+    const double trustedDocument = Measure([&]() { DoNotOptimize(JSON::ParseDocument(source, trusted).Root()); }, 5);
+    Report("  JSON::ParseDocument, validated", source.size(), document);
+    Report("  JSON::ParseDocument, validateUTF8 off", source.size(), trustedDocument);
+  }
+}
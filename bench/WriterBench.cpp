@@ -0,0 +1,124 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSON.h"
+#include "JSONWriter.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  /// The previous ToString: every level returns a temporary string that its parent copies.
+  std::string ConcatenateToString(const JSONValue& value)
+  {
+    if (value.IsDouble()) return std::to_string(value.AsDouble());
+    if (value.IsInt64() || value.IsUInt64()) return value.ToString();
+    if (value.IsBool()) return value.AsBool() ? "true" : "false";
+    if (value.IsString()) return "\"" + value.AsString() + "\"";
+
+    if (value.IsJSONArray())
+    {
+      std::string result = "[";
+      for (const auto& element : value.AsArray()) result += ConcatenateToString(element) + ", ";
+      return result.substr(0, result.size() - 2) + "]";
+    }
+
+    if (value.IsJSONObject())
+    {
+      std::string result = "{";
+      for (const auto& [key, member] : value.AsObject()) result += "\"" + key + "\": " + ConcatenateToString(member) + ", ";
+      return result.substr(0, result.size() - 2) + "}";
+    }
+    return "";
+  }
+}
+
+/**
+ * Compares the old concatenating ToString with a JSONWriter appending into one reused buffer,
+ * and with chunked writes to a file descriptor, counting heap allocations per document.
+ */
+void Bench::RunWriterBench()
+{
+  std::printf("\n--- Serialization ---\n");
+
+  const JSONValue value = JSON::Parse(GenerateRecords(20000));
+  const std::size_t bytes = value.ToString().size();
+
+  std::size_t concatenateAllocations = 0;
+  const double concatenate = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    DoNotOptimize(ConcatenateToString(value));
+    concatenateAllocations = AllocationCount() - before;
+  }, 3);
+
+  std::size_t toStringAllocations = 0;
+  const double toString = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    DoNotOptimize(value.ToString());
+    toStringAllocations = AllocationCount() - before;
+  }, 3);
+
+  std::string buffer;
+  std::size_t reusedAllocations = 0;
+  const double reused = Measure([&]()
+  {
+    const std::size_t before = AllocationCount();
+    buffer.clear();
+    JSONWriter(buffer).Write(value);
+    DoNotOptimize(buffer);
+    reusedAllocations = AllocationCount() - before;
+  }, 5);
+
+  Report("ToString by concatenation (before)", bytes, concatenate);
+  Report("ToString via JSONWriter", bytes, toString);
+  Report("JSONWriter into a reused buffer", bytes, reused);
+
+  // Short strings, where the per-string cost of finding escapes dominates.
+  std::vector<JSONValue> items;
+  for (std::size_t i = 0; i < 300000; i++) items.push_back(JSONValue{"item-" + std::to_string(i)});
+  const JSONValue strings{std::move(items)};
+  const std::size_t stringBytes = strings.ToString().size();
+  const double concatenateStrings = Measure([&]() { DoNotOptimize(ConcatenateToString(strings)); }, 3);
+  const double writeStrings = Measure([&]()
+  {
+    buffer.clear();
+    JSONWriter(buffer).Write(strings);
+    DoNotOptimize(buffer);
+  }, 5);
+  Report("Short strings by concatenation (before)", stringBytes, concatenateStrings);
+  Report("Short strings via JSONWriter", stringBytes, writeStrings);
+
+#if __has_include(<unistd.h>)
+  const int descriptor = ::open("/dev/null", O_WRONLY);
+  if (descriptor >= 0)
+  {
+    std::size_t descriptorAllocations = 0;
+    const double chunked = Measure([&]()
+    {
+      const std::size_t before = AllocationCount();
+      JSONWriter writer(descriptor);
+      writer.Write(value);
+      writer.Flush();
+      descriptorAllocations = AllocationCount() - before;
+    }, 5);
+    ::close(descriptor);
+    Report("JSONWriter to /dev/null in 64 KB chunks", bytes, chunked);
+    std::printf("allocations per document: concatenation %zu, ToString %zu, reused buffer %zu, descriptor %zu\n",
+                concatenateAllocations, toStringAllocations, reusedAllocations, descriptorAllocations);
+    return;
+  }
+#endif
+
+  std::printf("allocations per document: concatenation %zu, ToString %zu, reused buffer %zu\n",
+              concatenateAllocations, toStringAllocations, reusedAllocations);
+}
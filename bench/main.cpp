@@ -0,0 +1,63 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Runs every suite, or only the suites named on the command line, and optionally saves
+ * the results as JSON. Exits with status 1 if a suite's check failed.
+ */
+int main(const int argc, char** argv)
+{
+  const struct
+  {
+    std::string_view name;
+    void (*run)();
+  } suites[] = {
+    {"streaming", &Bench::RunStreamingBench},
+    {"lexer", &Bench::RunLexerBench},
+    {"document", &Bench::RunDocumentBench},
+    {"object", &Bench::RunObjectBench},
+    {"ondemand", &Bench::RunOnDemandBench},
+    {"sax", &Bench::RunSaxBench},
+    {"lines", &Bench::RunLinesBench},
+    {"parallel", &Bench::RunParallelBench},
+    {"numbers", &Bench::RunNumberBench},
+    {"writer", &Bench::RunWriterBench},
+    {"strings", &Bench::RunStringBench},
+    {"path", &Bench::RunPathBench},
+    {"bind", &Bench::RunBindBench},
+    {"snapshot", &Bench::RunSnapshotBench},
+    {"tape", &Bench::RunTapeBench},
+    {"reuse", &Bench::RunReuseBench},
+    {"corpora", &Bench::RunCorporaBench},
+    {"depth", &Bench::RunDepthBench},
+    {"utf8", &Bench::RunUTF8Bench},
+  };
+
+  // "--json <file>" writes the results as JSON; every other argument names a suite.
+  std::string resultsPath;
+  std::vector<std::string_view> selection;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::string_view(argv[i]) == "--json" && i + 1 < argc) resultsPath = argv[++i];
+    else selection.emplace_back(argv[i]);
+  }
+
+  for (const auto& suite : suites)
+  {
+    bool selected = selection.empty();
+    for (const std::string_view name : selection) selected |= suite.name == name;
+    if (!selected) continue;
+
+    Bench::BeginSuite(suite.name);
+    suite.run();
+  }
+
+  if (!resultsPath.empty()) Bench::SaveResults(resultsPath);
+  return Bench::AnyUnexpected() ? 1 : 0;
+}
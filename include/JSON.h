@@ -3,11 +3,64 @@
 //
 
 #pragma once
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <utility>
 #include <variant>
 #include <vector>
-#include <map>
 #include <stdexcept>
+#include "JSONCursor.h"
+#include "JSONDocument.h"
+#include "JSONObject.h"
+#include "JSONSnapshot.h"
+#include "JSONTape.h"
+
+struct JSONValue;
+
+/**
+ * @class JSONData
+ * @brief The std::variant a JSONValue keeps its data in, with a destructor and copy that do not
+ * recurse without bound.
+ *
+ * The implicit ones would recurse once per level of nesting and overflow the stack on a value
+ * that JSON::Parse accepted with a raised maxDepth. Up to RecursionLimit levels deep they recurse
+ * as usual; below that, the rest of the subtree is destroyed or copied from a stack on the heap.
+ * Everything else is inherited, so std::get, std::holds_alternative and assignment work as on
+ * the plain variant.
+ */
+class JSONData : public std::variant<std::monostate, double, bool, std::string, std::vector<JSONValue>, JSONObject, int64_t, uint64_t>
+{
+public:
+  using variant::variant;
+  using variant::operator=;
+
+  /// Levels of containers destroyed or copied on the call stack before the heap stack takes over.
+  static constexpr std::size_t RecursionLimit = 256;
+
+  JSONData() = default;
+  JSONData(const JSONData& other) : variant(other.HasChildren() ? CopyContainer(other) : variant(static_cast<const variant&>(other))) {}
+  JSONData(JSONData&& other) noexcept = default;
+  JSONData& operator=(const JSONData& other)
+  {
+    if (this != &other) *this = JSONData(other);
+    return *this;
+  }
+  JSONData& operator=(JSONData&& other) noexcept = default;
+
+  ~JSONData()
+  {
+    if (HasChildren()) DestroyChildren();
+  }
+
+private:
+  /// Whether this is an array or object with at least one child. Empty and moved-from
+  /// containers are left to the variant. Defined after JSONObjectMember, which it needs complete.
+  [[nodiscard]] bool HasChildren() const;
+
+  static variant CopyContainer(const JSONData& other);
+  void DestroyChildren() noexcept;
+};
 
 /**
  * @struct JSONValue
@@ -15,16 +68,16 @@
  *
  * The JSONValue structure is used to represent JSON data. It supports the following types:
  * - Null values
- * - Integers
+ * - Integers (int64_t, or uint64_t for values above INT64_MAX)
  * - Floating-point numbers
  * - Boolean values
  * - Strings
  * - JSON arrays (std::vector<JSONValue>)
- * - JSON objects (std::map<std::string, JSONValue>)
+ * - JSON objects (JSONObject, an insertion-ordered list of key/value pairs)
  */
 struct JSONValue
 {
-  std::variant<std::monostate, double, bool, std::string, std::vector<JSONValue>, std::map<std::string, JSONValue>> data;
+  JSONData data;
   static const JSONValue nullValue;
 
   // Helper for saving the JSONValue as a .json file
@@ -34,6 +87,8 @@ struct JSONValue
   {
     if (IsNull()) std::cout << "null";
     else if (IsDouble()) std::cout << "double";
+    else if (IsInt64()) std::cout << "int64";
+    else if (IsUInt64()) std::cout << "uint64";
     else if (IsBool()) std::cout << "bool";
     else if (IsString()) std::cout << "string";
     else if (IsJSONArray()) std::cout << "array";
@@ -43,12 +98,13 @@ struct JSONValue
   // Helpers to determine the type of data.
   [[nodiscard]] bool IsNull() const { return std::holds_alternative<std::monostate>(data); }
   [[nodiscard]] bool IsDouble() const { return std::holds_alternative<double>(data); }
+  [[nodiscard]] bool IsInt64() const { return std::holds_alternative<int64_t>(data); }
+  [[nodiscard]] bool IsUInt64() const { return std::holds_alternative<uint64_t>(data); }
+  [[nodiscard]] bool IsNumber() const { return IsDouble() || IsInt64() || IsUInt64(); }
   [[nodiscard]] bool IsBool() const { return std::holds_alternative<bool>(data); }
   [[nodiscard]] bool IsString() const { return std::holds_alternative<std::string>(data); }
   [[nodiscard]] bool IsJSONArray() const { return std::holds_alternative<std::vector<JSONValue>>(data); }
-  [[nodiscard]] bool IsJSONObject() const { return std::holds_alternative<std::map<std::string, JSONValue>>(data); }
-
-  JSONValue& operator=(const JSONValue& other) = default;
+  [[nodiscard]] bool IsJSONObject() const { return std::holds_alternative<JSONObject>(data); }
 
   // ##################################
   // Helper functions for the JSONArray
@@ -99,37 +155,26 @@ struct JSONValue
   // Helper functions for the JSONObject
   // ###################################
 
-  /// Return the data as a const reference to std::map<std::string, JSONValue>
+  /// Return the data as a const reference to JSONObject
   /// Throws an error if the data is not a JSONObject
-  [[nodiscard]] const std::map<std::string, JSONValue>& AsObject() const
+  [[nodiscard]] const JSONObject& AsObject() const
   {
     if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
-    return std::get<std::map<std::string, JSONValue>>(data);
+    return std::get<JSONObject>(data);
   }
 
-  /// Return the data as a reference to std::map<std::string, JSONValue>
+  /// Return the data as a reference to JSONObject
   /// Throws an error if the data is not a JSONObject
-  [[nodiscard]] std::map<std::string, JSONValue>& AsObject()
+  [[nodiscard]] JSONObject& AsObject()
   {
     if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
-    return std::get<std::map<std::string, JSONValue>>(data);
+    return std::get<JSONObject>(data);
   }
 
   /// Return a const reference to the data at the given index.
   /// Throws an error if the data is not a JSONObject
   /// @warning Returns a std::monostate if the index is invalid
-  const JSONValue& operator[](const std::string& key) const
-  {
-    if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
-    try
-    {
-      return std::get<std::map<std::string, JSONValue>>(data).at(key);
-    }
-    catch (const std::out_of_range&)
-    {
-      return nullValue;
-    }
-  }
+  const JSONValue& operator[](const std::string& key) const;
 
   /// Return a const reference to the data at the given index.
   /// Throws an error if the data is not a JSONObject
@@ -143,7 +188,7 @@ struct JSONValue
   JSONValue& operator[](const std::string& key)
   {
     if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
-    return std::get<std::map<std::string, JSONValue>>(data)[key];
+    return std::get<JSONObject>(data)[key];
   }
 
   /// Return a reference to the data at the given index.
@@ -176,29 +221,61 @@ struct JSONValue
   // Get int
   [[nodiscard]] int AsInt() const
   {
-    if (IsNull()) return 0;
-    if (!IsDouble()) throw std::runtime_error("Cannot convert non-double JSON value to double");
-    return static_cast<int>(std::get<double>(data));
+    if (IsInt64()) return static_cast<int>(std::get<int64_t>(data));
+    return static_cast<int>(AsDouble());
   }
 
   [[nodiscard]] int AsInt()
   {
-    if (IsNull()) data = 0.0;
-    if (!IsDouble()) throw std::runtime_error("Cannot convert non-double JSON value to double");
-    return static_cast<int>(std::get<double>(data));
+    if (IsNull()) data = int64_t{0};
+    return std::as_const(*this).AsInt();
+  }
+
+  /// Return the number as a signed 64-bit integer, exactly if it was written as one.
+  /// Throws an error if the data is not a number or an unsigned integer does not fit.
+  [[nodiscard]] int64_t AsInt64() const
+  {
+    if (IsNull()) return 0;
+    if (IsInt64()) return std::get<int64_t>(data);
+    if (IsUInt64())
+    {
+      if (std::get<uint64_t>(data) > static_cast<uint64_t>(INT64_MAX)) throw std::runtime_error("JSON integer does not fit in int64_t");
+      return static_cast<int64_t>(std::get<uint64_t>(data));
+    }
+    if (!IsDouble()) throw std::runtime_error("Cannot convert non-number JSON value to int64_t");
+    return static_cast<int64_t>(std::get<double>(data));
+  }
+
+  /// Return the number as an unsigned 64-bit integer, exactly if it was written as one.
+  /// Throws an error if the data is not a number or is a negative integer.
+  [[nodiscard]] uint64_t AsUInt64() const
+  {
+    if (IsNull()) return 0;
+    if (IsUInt64()) return std::get<uint64_t>(data);
+    if (IsInt64())
+    {
+      if (std::get<int64_t>(data) < 0) throw std::runtime_error("Negative JSON integer does not fit in uint64_t");
+      return static_cast<uint64_t>(std::get<int64_t>(data));
+    }
+    if (!IsDouble()) throw std::runtime_error("Cannot convert non-number JSON value to uint64_t");
+    return static_cast<uint64_t>(std::get<double>(data));
   }
 
   // Get double
   [[nodiscard]] double AsDouble() const
   {
     if (IsNull()) return 0.0;
+    if (IsInt64()) return static_cast<double>(std::get<int64_t>(data));
+    if (IsUInt64()) return static_cast<double>(std::get<uint64_t>(data));
     if (!IsDouble()) throw std::runtime_error("Cannot convert non-double JSON value to double");
     return std::get<double>(data);
   }
 
+  /// Integers are converted to a double in place, so a reference can be returned.
   [[nodiscard]] double& AsDouble()
   {
     if (IsNull()) data = 0.0;
+    if (IsInt64() || IsUInt64()) data = std::as_const(*this).AsDouble();
     if (!IsDouble()) throw std::runtime_error("Cannot convert non-double JSON value to double");
     return std::get<double>(data);
   }
@@ -218,8 +295,143 @@ struct JSONValue
     return std::get<bool>(data);
   }
 };
+
 inline const JSONValue JSONValue::nullValue = {};
 
+/**
+ * @class JSONObjectMember
+ * @brief A key/value pair of a JSONObject.
+ *
+ * The key can only be read from outside the object, so it cannot get out of step with the
+ * object's index, yet members still move without copying their keys when the member
+ * vector grows. Members unpack like a std::pair: `for (auto& [key, value] : object)`.
+ */
+class JSONObjectMember
+{
+public:
+  explicit JSONObjectMember(std::string key, JSONValue value = {}) : m_key(std::move(key)), m_value(std::move(value)) {}
+
+  [[nodiscard]] const std::string& Key() const { return m_key; }
+  [[nodiscard]] JSONValue& Value() { return m_value; }
+  [[nodiscard]] const JSONValue& Value() const { return m_value; }
+
+  template <std::size_t Index>
+  [[nodiscard]] decltype(auto) get() const
+  {
+    if constexpr (Index == 0) return Key();
+    else return Value();
+  }
+
+  template <std::size_t Index>
+  [[nodiscard]] decltype(auto) get()
+  {
+    if constexpr (Index == 0) return Key();
+    else return Value();
+  }
+
+private:
+  std::string m_key;
+  JSONValue m_value;
+};
+
+inline bool JSONData::HasChildren() const
+{
+  if (const auto* array = std::get_if<std::vector<JSONValue>>(this)) return !array->empty();
+  if (const auto* object = std::get_if<JSONObject>(this)) return !object->empty();
+  return false;
+}
+
+template <>
+struct std::tuple_size<JSONObjectMember> : std::integral_constant<std::size_t, 2> {};
+
+template <>
+struct std::tuple_element<0, JSONObjectMember> { using type = const std::string; };
+
+template <>
+struct std::tuple_element<1, JSONObjectMember> { using type = JSONValue; };
+
+inline const JSONValue& JSONValue::operator[](const std::string& key) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  const JSONObject& object = std::get<JSONObject>(data);
+  const auto member = object.find(key);
+  return member == object.end() ? nullValue : member->Value();
+}
+
+/**
+ * @struct ParseOptions
+ * @brief Settings that change how JSON::ParseDocument builds a document. JSON::Parse,
+ * JSON::ParseTape, JSON::ParseParallel, JSON::ParseLines, SAXParser and JSONStreamParser only
+ * use maxDepth and validateUTF8. JSON::ParseOnDemand, JSONPath and JSONBinder use validateUTF8.
+ */
+struct ParseOptions
+{
+  static constexpr std::size_t DefaultMaxDepth = 1024;
+
+  /// Deepest nesting of arrays and objects to accept. Deeper input is rejected with a
+  /// std::runtime_error. The parsers keep open containers on the heap, and so do writing,
+  /// copying, converting and destroying what they return, so a raised limit costs memory in
+  /// proportion to the depth but does not put the call stack at risk.
+  std::size_t maxDepth = DefaultMaxDepth;
+
+  /// Reject strings that are not valid UTF-8. Turning this off skips the check for trusted
+  /// input; strings then keep whatever bytes the source has.
+  bool validateUTF8 = true;
+
+  /// Keep strings and keys without escape sequences as views into the source instead
+  /// of copying them. Only strings containing a backslash escape are decoded into the
+  /// document. The source must then outlive the document.
+  bool zeroCopyStrings = false;
+
+  /// Intern object keys in this table instead of the document's own one, so keys are shared
+  /// across parses. The table must outlive every document parsed with it.
+  KeyTable* keyTable = nullptr;
+};
+
+/**
+ * @struct ParseStats
+ * @brief Where a parse spent its time and memory, filled in by the JSON::Parse and
+ * JSON::LoadFromFile overloads that take one.
+ *
+ * Collecting statistics reads the clock around every token, number and string, which slows
+ * the parse down noticeably, so use the numbers to compare stages rather than as absolute
+ * timings. The overloads without a ParseStats are not instrumented at all.
+ */
+struct ParseStats
+{
+  std::size_t bytes = 0; // Size of the source
+
+  // Tokens by type
+  std::size_t tokens = 0; // All of the below
+  std::size_t objectBegins = 0;
+  std::size_t objectEnds = 0;
+  std::size_t arrayBegins = 0;
+  std::size_t arrayEnds = 0;
+  std::size_t colons = 0;
+  std::size_t commas = 0;
+  std::size_t strings = 0; // Keys and values
+  std::size_t integers = 0;
+  std::size_t doubles = 0;
+  std::size_t trues = 0;
+  std::size_t falses = 0;
+  std::size_t nulls = 0;
+
+  std::size_t maxDepth = 0;       // Deepest nesting of containers, 0 if the root is not a container
+  std::size_t unescapedBytes = 0; // Raw size of the strings that contained escape sequences
+
+  // Heap allocations made for the resulting JSONValue: long strings, array elements and object members
+  std::size_t allocations = 0;
+  std::size_t allocatedBytes = 0;
+
+  // Wall-clock time per stage. Building is the rest: creating values and filling containers.
+  uint64_t totalNanoseconds = 0;
+  uint64_t readNanoseconds = 0; // Opening and mapping the file, LoadFromFile only
+  uint64_t lexNanoseconds = 0;
+  uint64_t numberNanoseconds = 0;
+  uint64_t stringNanoseconds = 0; // Copying and unescaping keys and strings
+  uint64_t buildNanoseconds = 0;
+};
+
 /**
  * @class JSON
  * @brief A utility class for working with JSON data. Provides methods to parse and load JSON strings into JSONValue objects.
@@ -231,6 +443,24 @@ class JSON
 {
 public:
   static JSONValue Parse(const std::string& source);
+  static JSONValue Parse(const std::string& source, ParseStats& stats);
+  static JSONValue Parse(const std::string& source, const ParseOptions& options);
+  static JSONValue ParseParallel(std::string_view source, unsigned int threads = 0, const ParseOptions& options = {});
+  static JSONDocument ParseDocument(std::string_view source, const ParseOptions& options = {});
+  static JSONTape ParseTape(std::string_view source, const ParseOptions& options = {});
+  static JSONCursor ParseOnDemand(std::string_view source, const ParseOptions& options = {});
   static JSONValue LoadFromFile(const std::string& filepath);
+  static JSONValue LoadFromFile(const std::string& filepath, ParseStats& stats);
+  static JSONDocument LoadDocumentFromFile(const std::string& filepath, const ParseOptions& options = {});
+
+  // JSON Lines: one value per line, parsed on `threads` threads (0 = all hardware threads)
+  static std::vector<JSONValue> ParseLines(std::string_view source, unsigned int threads = 0, const ParseOptions& options = {});
+  static void ParseLines(std::string_view source, const std::function<void(JSONValue&&)>& callback, unsigned int threads = 0,
+                         const ParseOptions& options = {});
+  static std::vector<JSONValue> LoadLinesFromFile(const std::string& filepath, unsigned int threads = 0, const ParseOptions& options = {});
   static void SaveToFile(const std::string& filepath, const JSONValue& value);
+
+  // Binary snapshots: saved once from a parsed value, then mapped and navigated without parsing
+  static void SaveBinary(const std::string& filepath, const JSONValue& value);
+  static JSONSnapshot LoadBinary(const std::string& filepath);
 };
\ No newline at end of file
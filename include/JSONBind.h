@@ -0,0 +1,601 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSONTokenizer.h"
+#include "JSONWriter.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct JSONField
+ * @brief Binds the JSON key `name` to the data member `member` of `Struct`.
+ */
+template <typename Struct, typename Member>
+struct JSONField
+{
+  std::string_view name;
+  Member Struct::* member;
+};
+
+/**
+ * @struct JSONBinding
+ * @brief Lists the fields of a struct that JSONBinder reads from and writes to JSON.
+ *
+ * Specialize it with a `static constexpr std::tuple fields` of JSONField entries, or let
+ * JSON_BIND do so, at global scope, for fields whose key is the member name:
+ *
+ * @code
+ * struct Fill { double price; int64_t quantity; };
+ * struct Order { std::string symbol; std::vector<Fill> fills; std::optional<std::string> note; };
+ * JSON_BIND(Fill, price, quantity)
+ * JSON_BIND(Order, symbol, fills, note)
+ * @endcode
+ */
+template <typename T>
+struct JSONBinding;
+
+template <typename T>
+concept JSONBound = requires { std::tuple_size<std::remove_cvref_t<decltype(JSONBinding<T>::fields)>>::value; };
+
+// JSON_BIND expands its field list with a recursive __VA_OPT__ loop (up to 256 fields).
+#define JSON_BIND_PARENS ()
+#define JSON_BIND_EXPAND(...) JSON_BIND_EXPAND3(JSON_BIND_EXPAND3(JSON_BIND_EXPAND3(JSON_BIND_EXPAND3(__VA_ARGS__))))
+#define JSON_BIND_EXPAND3(...) JSON_BIND_EXPAND2(JSON_BIND_EXPAND2(JSON_BIND_EXPAND2(JSON_BIND_EXPAND2(__VA_ARGS__))))
+#define JSON_BIND_EXPAND2(...) JSON_BIND_EXPAND1(JSON_BIND_EXPAND1(JSON_BIND_EXPAND1(JSON_BIND_EXPAND1(__VA_ARGS__))))
+#define JSON_BIND_EXPAND1(...) __VA_ARGS__
+#define JSON_BIND_FIELDS(Type, ...) __VA_OPT__(JSON_BIND_EXPAND(JSON_BIND_FIELDS_NEXT(Type, __VA_ARGS__)))
+#define JSON_BIND_FIELDS_NEXT(Type, field, ...) \
+  JSONField<Type, decltype(Type::field)>{#field, &Type::field} __VA_OPT__(, JSON_BIND_FIELDS_AGAIN JSON_BIND_PARENS (Type, __VA_ARGS__))
+#define JSON_BIND_FIELDS_AGAIN() JSON_BIND_FIELDS_NEXT
+
+#define JSON_BIND(Type, ...) \
+  template <> \
+  struct JSONBinding<Type> \
+  { \
+    static constexpr std::tuple fields{JSON_BIND_FIELDS(Type, __VA_ARGS__)}; \
+  };
+
+namespace JSONBindDetail
+{
+  template <typename T>
+  struct IsOptional : std::false_type {};
+  template <typename T>
+  struct IsOptional<std::optional<T>> : std::true_type {};
+
+  template <typename T>
+  struct IsVector : std::false_type {};
+  template <typename T, typename Allocator>
+  struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+  /// Maps with string keys are read and written as JSON objects.
+  template <typename T>
+  struct IsMap : std::false_type {};
+  template <typename T, typename Compare, typename Allocator>
+  struct IsMap<std::map<std::string, T, Compare, Allocator>> : std::true_type {};
+  template <typename T, typename Hash, typename Equal, typename Allocator>
+  struct IsMap<std::unordered_map<std::string, T, Hash, Equal, Allocator>> : std::true_type {};
+
+  /// True if reading into an existing T, other than from null, leaves nothing of its old
+  /// value behind. Such vector elements are reused across parses, keeping their capacity.
+  /// A bound struct keeps the fields its JSON leaves out, so it is not.
+  template <typename T>
+  struct IsOverwritten : std::bool_constant<std::is_arithmetic_v<T> || std::is_same_v<T, std::string> ||
+                                            std::is_same_v<T, JSONValue> || IsMap<T>::value> {};
+  template <typename T, typename Allocator>
+  struct IsOverwritten<std::vector<T, Allocator>> : IsOverwritten<T> {};
+
+  /// FNV-1a, with the seed mixed into the offset basis.
+  constexpr uint32_t HashKey(const std::string_view key, const uint32_t seed)
+  {
+    uint32_t hash = 2166136261u ^ seed;
+    for (const char c : key) hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    return hash;
+  }
+
+  /**
+   * @struct FieldTable
+   * @brief A perfect hash from the keys of a bound struct to its field indices, built at compile time.
+   *
+   * The table has at least Count² slots, so a seed that places every key in its own slot is
+   * found within a few tries. A lookup is one hash, one table load and one key comparison.
+   */
+  template <typename T>
+  struct FieldTable
+  {
+    static constexpr std::size_t Count = std::tuple_size_v<std::remove_cvref_t<decltype(JSONBinding<T>::fields)>>;
+    static constexpr std::size_t Slots = std::bit_ceil(std::max<std::size_t>(Count * Count, 1));
+    static_assert(Count < 255, "Too many fields in one JSONBinding");
+
+    static constexpr std::array<std::string_view, Count> names = std::apply(
+      [](const auto&... field) { return std::array<std::string_view, Count>{field.name...}; }, JSONBinding<T>::fields);
+
+    static constexpr uint32_t seed = []()
+    {
+      for (uint32_t candidate = 0; ; candidate++)
+      {
+        std::array<bool, Slots> used{};
+        bool collision = false;
+        for (const std::string_view name : names)
+        {
+          bool& slot = used[HashKey(name, candidate) & (Slots - 1)];
+          collision |= slot;
+          slot = true;
+        }
+        if (!collision) return candidate;
+      }
+    }();
+
+    // Field index + 1 for every slot, 0 for free slots.
+    static constexpr std::array<uint8_t, Slots> slots = []()
+    {
+      std::array<uint8_t, Slots> table{};
+      for (std::size_t i = 0; i < Count; i++) table[HashKey(names[i], seed) & (Slots - 1)] = static_cast<uint8_t>(i + 1);
+      return table;
+    }();
+
+    /// Index of the field bound to `key`, or Count if there is none.
+    static constexpr std::size_t Find(const std::string_view key)
+    {
+      const uint8_t entry = slots[HashKey(key, seed) & (Slots - 1)];
+      return entry != 0 && names[entry - 1] == key ? entry - 1 : Count;
+    }
+  };
+
+  /**
+   * @class Reader
+   * @brief Reads tokens from a JSONTokenizer straight into bound structs and their fields.
+   */
+  class Reader
+  {
+  public:
+    Reader(const std::string_view source, const bool validateUTF8)
+      : m_source(source), m_validateUTF8(validateUTF8), m_lexer(source, validateUTF8), m_current(m_lexer.NextToken()) {}
+
+    template <typename T>
+    void ReadRoot(T& value)
+    {
+      Read(value);
+      if (m_current.type != TokenType::END_OF_FILE) throw std::runtime_error("Unexpected data after end of JSON");
+    }
+
+  private:
+    std::string_view m_source;
+    bool m_validateUTF8;
+    JSONTokenizer m_lexer;
+    Token m_current;
+    std::string m_scratch;
+
+    void Next() { m_current = m_lexer.NextToken(); }
+
+    void Expect(const TokenType type) const
+    {
+      if (m_current.type != type) throw std::runtime_error("Unexpected token type");
+    }
+
+    /// Return the decoded string, a view into the source if it has no escapes.
+    std::string_view Decode(const Token& token)
+    {
+      if (!token.escaped) return token.value;
+      m_scratch.resize(token.value.size());
+      m_scratch.resize(JSONTokenizer::Unescape(token.value, m_scratch.data()));
+      return m_scratch;
+    }
+
+    ParsedNumber Number() const
+    {
+      if (m_current.type != TokenType::INT && m_current.type != TokenType::DOUBLE) throw std::runtime_error("Expected a JSON number");
+      return JSONTokenizer::ParseNumber(m_current);
+    }
+
+    /// A null leaves a field that is not optional unchanged.
+    template <typename T>
+    void Read(T& value)
+    {
+      if constexpr (!IsOptional<T>::value && !std::is_same_v<T, JSONValue>)
+      {
+        if (m_current.type == TokenType::NULL_TYPE)
+        {
+          Next();
+          return;
+        }
+      }
+
+      if constexpr (std::is_same_v<T, bool>)
+      {
+        if (m_current.type != TokenType::TRUE && m_current.type != TokenType::FALSE) throw std::runtime_error("Expected a JSON bool");
+        value = m_current.type == TokenType::TRUE;
+        Next();
+      }
+      else if constexpr (std::is_integral_v<T>)
+      {
+        const ParsedNumber number = Number();
+        if (number.type == JSONType::Double) throw std::runtime_error("Expected a JSON integer");
+        const bool fits = number.type == JSONType::Int64 ? std::in_range<T>(number.integer) : std::in_range<T>(number.unsignedInteger);
+        if (!fits) throw std::runtime_error("JSON integer does not fit in field: " + std::string(m_current.value));
+        value = number.type == JSONType::Int64 ? static_cast<T>(number.integer) : static_cast<T>(number.unsignedInteger);
+        Next();
+      }
+      else if constexpr (std::is_floating_point_v<T>)
+      {
+        const ParsedNumber number = Number();
+        if (number.type == JSONType::Int64) value = static_cast<T>(number.integer);
+        else if (number.type == JSONType::UInt64) value = static_cast<T>(number.unsignedInteger);
+        else value = static_cast<T>(number.number);
+        Next();
+      }
+      else if constexpr (std::is_same_v<T, std::string>)
+      {
+        Expect(TokenType::STRING);
+        value.assign(Decode(m_current));
+        Next();
+      }
+      else if constexpr (IsOptional<T>::value)
+      {
+        if (m_current.type == TokenType::NULL_TYPE)
+        {
+          value.reset();
+          Next();
+          return;
+        }
+        if (!value) value.emplace();
+        Read(*value);
+      }
+      else if constexpr (IsVector<T>::value)
+      {
+        Expect(TokenType::LEFT_BRACKET);
+        Next();
+        std::size_t count = 0;
+        while (m_current.type != TokenType::RIGHT_BRACKET)
+        {
+          if (count == value.size()) Read(value.emplace_back());
+          else ReadElement(value[count]);
+          count++;
+          if (m_current.type != TokenType::RIGHT_BRACKET)
+          {
+            Expect(TokenType::COMMA);
+            Next();
+          }
+        }
+        value.erase(value.begin() + static_cast<std::ptrdiff_t>(count), value.end());
+        Next(); // Eat ending bracket
+      }
+      else if constexpr (IsMap<T>::value)
+      {
+        Expect(TokenType::LEFT_BRACE);
+        Next();
+        value.clear();
+        while (m_current.type != TokenType::RIGHT_BRACE)
+        {
+          Expect(TokenType::STRING);
+          std::string key(Decode(m_current));
+          Next();
+
+          Expect(TokenType::COLON);
+          Next();
+
+          Read(value[std::move(key)]);
+          if (m_current.type != TokenType::RIGHT_BRACE)
+          {
+            Expect(TokenType::COMMA);
+            Next();
+          }
+        }
+        Next(); // Eat the ending brace
+      }
+      else if constexpr (std::is_same_v<T, JSONValue>)
+      {
+        // Free-form data: parse the subtree, then step over it.
+        value = JSONTokenizer::ParsePrefix(m_source.substr(m_current.Begin() - m_source.data()), m_validateUTF8);
+        Skip();
+      }
+      else if constexpr (JSONBound<T>)
+      {
+        ReadObject(value);
+      }
+      else
+      {
+        static_assert(JSONBound<T>, "Field type cannot be read from JSON; declare a JSONBinding for it");
+      }
+    }
+
+    /// Members are matched to fields by the perfect hash; unknown keys are skipped.
+    template <typename T>
+    void ReadObject(T& value)
+    {
+      using Table = FieldTable<T>;
+
+      Expect(TokenType::LEFT_BRACE);
+      Next();
+
+      while (m_current.type != TokenType::RIGHT_BRACE)
+      {
+        Expect(TokenType::STRING);
+        const std::size_t field = Table::Find(Decode(m_current));
+        Next();
+
+        Expect(TokenType::COLON);
+        Next();
+
+        if (field == Table::Count) Skip();
+        else ReadField(value, field, std::make_index_sequence<Table::Count>{});
+
+        if (m_current.type != TokenType::RIGHT_BRACE)
+        {
+          Expect(TokenType::COMMA);
+          Next();
+        }
+      }
+
+      Next(); // Eat the ending brace
+    }
+
+    /// Read into an element left over from an earlier parse, so that it ends up as if it had
+    /// been freshly appended.
+    template <typename T>
+    void ReadElement(T& element)
+    {
+      if (!IsOverwritten<T>::value || m_current.type == TokenType::NULL_TYPE) element = T{};
+      Read(element);
+    }
+
+    template <typename T, std::size_t... I>
+    void ReadField(T& value, const std::size_t field, std::index_sequence<I...>)
+    {
+      static_cast<void>(((field == I ? (Read(value.*std::get<I>(JSONBinding<T>::fields).member), true) : false) || ...));
+    }
+
+    void Skip()
+    {
+      m_lexer.SkipValue(m_current);
+      Next();
+    }
+  };
+}
+
+namespace JSONBindDetail
+{
+  /// The letter of the two-character escape for `c`, as JSONWriter uses it, or 0.
+  constexpr char ShortEscape(const char c)
+  {
+    switch (c)
+    {
+      case '"': return '"';
+      case '\\': return '\\';
+      case '\b': return 'b';
+      case '\f': return 'f';
+      case '\n': return 'n';
+      case '\r': return 'r';
+      case '\t': return 't';
+      default: return 0;
+    }
+  }
+
+  /// Length of `text` once escaped as the contents of a JSON string.
+  constexpr std::size_t EscapedLength(const std::string_view text)
+  {
+    std::size_t length = 0;
+    for (const char c : text)
+    {
+      if (ShortEscape(c) != 0) length += 2;
+      else if (static_cast<unsigned char>(c) < 0x20) length += 6;
+      else length++;
+    }
+    return length;
+  }
+
+  /**
+   * @struct KeyPrefix
+   * @brief Everything written before the value of field I, encoded at compile time.
+   *
+   * For the first field this is `{"name": `, for the others `, "name": `, so a whole
+   * struct is written as one fixed fragment per field plus the values and a closing brace.
+   */
+  template <typename T, std::size_t I>
+  struct KeyPrefix
+  {
+    static constexpr std::string_view name = std::get<I>(JSONBinding<T>::fields).name;
+    static constexpr std::size_t Length = (I == 0 ? 1 : 2) + EscapedLength(name) + 4;
+
+    static constexpr std::array<char, Length> text = []()
+    {
+      constexpr char hex[] = "0123456789abcdef";
+      std::array<char, Length> result{};
+      std::size_t i = 0;
+      if (I == 0) result[i++] = '{';
+      else
+      {
+        result[i++] = ',';
+        result[i++] = ' ';
+      }
+
+      result[i++] = '"';
+      for (const char c : name)
+      {
+        const auto byte = static_cast<unsigned char>(c);
+        if (ShortEscape(c) != 0)
+        {
+          result[i++] = '\\';
+          result[i++] = ShortEscape(c);
+        }
+        else if (byte < 0x20)
+        {
+          for (const char e : {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xF]}) result[i++] = e;
+        }
+        else result[i++] = c;
+      }
+      result[i++] = '"';
+      result[i++] = ':';
+      result[i++] = ' ';
+      return result;
+    }();
+
+    static constexpr std::string_view View() { return {text.data(), Length}; }
+  };
+
+  /**
+   * @class Writer
+   * @brief Writes bound structs and their fields to a JSONWriter, without building a tree.
+   */
+  class Writer
+  {
+  public:
+    explicit Writer(JSONWriter& out) : m_out(out) {}
+
+    /// An empty optional is written as null.
+    template <typename T>
+    void Write(const T& value)
+    {
+      if constexpr (std::is_same_v<T, bool>)
+      {
+        m_out.WriteBool(value);
+      }
+      else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+      {
+        m_out.WriteNumber(static_cast<int64_t>(value));
+      }
+      else if constexpr (std::is_integral_v<T>)
+      {
+        m_out.WriteNumber(static_cast<uint64_t>(value));
+      }
+      else if constexpr (std::is_floating_point_v<T>)
+      {
+        m_out.WriteNumber(static_cast<double>(value));
+      }
+      else if constexpr (std::is_same_v<T, std::string>)
+      {
+        m_out.WriteString(value);
+      }
+      else if constexpr (IsOptional<T>::value)
+      {
+        if (value) Write(*value);
+        else m_out.WriteNull();
+      }
+      else if constexpr (IsVector<T>::value)
+      {
+        m_out.WriteRaw("[");
+        bool first = true;
+        for (const auto& element : value)
+        {
+          if (!first) m_out.WriteRaw(", ");
+          first = false;
+          Write(element);
+        }
+        m_out.WriteRaw("]");
+      }
+      else if constexpr (IsMap<T>::value)
+      {
+        m_out.WriteRaw("{");
+        bool first = true;
+        for (const auto& [key, member] : value)
+        {
+          if (!first) m_out.WriteRaw(", ");
+          first = false;
+          m_out.WriteString(key);
+          m_out.WriteRaw(": ");
+          Write(member);
+        }
+        m_out.WriteRaw("}");
+      }
+      else if constexpr (std::is_same_v<T, JSONValue>)
+      {
+        m_out.Write(value);
+      }
+      else if constexpr (JSONBound<T>)
+      {
+        WriteObject(value, std::make_index_sequence<FieldTable<T>::Count>{});
+      }
+      else
+      {
+        static_assert(JSONBound<T>, "Field type cannot be written as JSON; declare a JSONBinding for it");
+      }
+    }
+
+  private:
+    JSONWriter& m_out;
+
+    template <typename T, std::size_t... I>
+    void WriteObject(const T& value, std::index_sequence<I...>)
+    {
+      if constexpr (sizeof...(I) == 0) m_out.WriteRaw("{}");
+      else
+      {
+        ((m_out.WriteRaw(KeyPrefix<T, I>::View()), Write(value.*std::get<I>(JSONBinding<T>::fields).member)), ...);
+        m_out.WriteRaw("}");
+      }
+    }
+  };
+}
+
+/**
+ * @class JSONBinder
+ * @brief Parses JSON directly into a struct declared with JSON_BIND, and writes it back, without building a tree.
+ *
+ * Fields may be bools, integers, floating-point numbers, std::string, JSONValue, other bound
+ * structs, and std::optional, std::vector or string-keyed std::map / std::unordered_map of
+ * any of these. When parsing, keys without a field are skipped,
+ * and fields without a key keep their value. Integers must fit the field they are read into.
+ * T itself may be any of the field types, e.g. std::vector<Order> for an array of orders.
+ *
+ * @code
+ * Order order = JSONBinder<Order>::Parse(source);
+ * JSONBinder<Order>::Write(order, writer);
+ * @endcode
+ */
+template <typename T>
+class JSONBinder
+{
+public:
+  /// Parse `source` into a value-initialised T. Throws std::runtime_error on invalid input.
+  /// Only `options.validateUTF8` applies.
+  static T Parse(const std::string_view source, const ParseOptions& options = {})
+  {
+    T value{};
+    Parse(source, value, options);
+    return value;
+  }
+
+  /// Parse `source` into an existing value. Fields that `source` leaves out keep their values.
+  /// Vectors keep their capacity and their elements: strings, numbers and vectors of them are
+  /// read in place, so they keep their capacity too, while other elements are reset first.
+  static void Parse(const std::string_view source, T& value, const ParseOptions& options = {})
+  {
+    JSONBindDetail::Reader reader(source, options.validateUTF8);
+    reader.ReadRoot(value);
+  }
+
+  /// Write `value` to `out`, in the same format as JSONValue::ToString().
+  static void Write(const T& value, JSONWriter& out)
+  {
+    JSONBindDetail::Writer writer(out);
+    writer.Write(value);
+  }
+
+  /// Append `value` to `buffer`. Clearing and reusing the buffer keeps its capacity.
+  static void Write(const T& value, std::string& buffer)
+  {
+    JSONWriter out(buffer);
+    Write(value, out);
+  }
+
+  [[nodiscard]] static std::string ToString(const T& value)
+  {
+    std::string result;
+    Write(value, result);
+    return result;
+  }
+};
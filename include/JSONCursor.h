@@ -0,0 +1,74 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+struct JSONValue;
+
+/**
+ * @class JSONCursor
+ * @brief A lightweight handle to a value inside unparsed JSON text.
+ *
+ * A cursor only remembers where its value starts in the source. Looking up a key or an
+ * index lexes forward from there, and every container that is passed over on the way is
+ * skipped by matching its braces or brackets instead of being built. Nothing is
+ * materialised until ToJSONValue() is called. The source must outlive every cursor into it.
+ *
+ * A cursor for a missing key or index behaves like a null value, as on a const JSONValue.
+ * Only the parts of the input that are actually visited are checked for syntax errors.
+ */
+class JSONCursor
+{
+public:
+  JSONCursor() = default;
+
+  /// Unless `validateUTF8` is false, strings that are lexed are checked for valid UTF-8.
+  explicit JSONCursor(std::string_view source, bool validateUTF8 = true);
+
+  // Helpers to determine the type of data.
+  [[nodiscard]] bool Exists() const { return !m_text.empty(); }
+  [[nodiscard]] bool IsNull() const;
+  [[nodiscard]] bool IsDouble() const { return Exists() && (m_text.front() == '-' || (m_text.front() >= '0' && m_text.front() <= '9')); }
+  [[nodiscard]] bool IsBool() const;
+  [[nodiscard]] bool IsString() const { return Exists() && m_text.front() == '"'; }
+  [[nodiscard]] bool IsJSONArray() const { return Exists() && m_text.front() == '['; }
+  [[nodiscard]] bool IsJSONObject() const { return Exists() && m_text.front() == '{'; }
+
+  /// Return a cursor to the element at the given index, skipping the elements before it.
+  /// Throws an error if the value is not an array.
+  /// @warning Returns a missing (null) cursor if the index is invalid
+  JSONCursor operator[](int index) const;
+
+  /// Return a cursor to the member with the given key, the last one if the key is repeated.
+  /// Every member of the object is skipped over. Throws an error if the value is not an object.
+  /// @warning Returns a missing (null) cursor if the key is not present
+  JSONCursor operator[](std::string_view key) const;
+  JSONCursor operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+  /// Number of elements or members. Throws an error if the value is not a container.
+  [[nodiscard]] std::size_t Size() const;
+
+  [[nodiscard]] std::string AsString() const;
+  [[nodiscard]] double AsDouble() const;
+  [[nodiscard]] int AsInt() const { return static_cast<int>(AsDouble()); }
+  [[nodiscard]] int64_t AsInt64() const;
+  [[nodiscard]] uint64_t AsUInt64() const;
+  [[nodiscard]] bool AsBool() const;
+
+  /// Parse the value, and everything inside it, into an owning JSONValue.
+  [[nodiscard]] JSONValue ToJSONValue() const;
+
+private:
+  friend class JSONPath;
+
+  void CheckLiteral(std::string_view literal) const;
+
+  // From the first character of the value to the end of the source.
+  std::string_view m_text;
+  bool m_validateUTF8 = true;
+};
@@ -0,0 +1,316 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+struct JSONValue;
+
+/**
+ * @class Arena
+ * @brief A bump allocator that hands out memory from a short list of large chunks.
+ *
+ * Individual allocations are never freed. All memory is released at once when the
+ * arena is destroyed, so tearing down a document costs one free per chunk instead
+ * of one per node.
+ */
+class Arena
+{
+public:
+  Arena() = default;
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  Arena(Arena&& other) noexcept;
+  Arena& operator=(Arena&& other) noexcept;
+
+  /// Make sure the next chunk is at least `bytes` large.
+  void Reserve(std::size_t bytes);
+
+  /// Return `bytes` bytes aligned to `alignment`. Never returns nullptr.
+  void* Allocate(std::size_t bytes, std::size_t alignment);
+
+  /// Discard every allocation but keep the largest chunk, so refilling the arena with about as
+  /// much data as before needs no heap allocation. BytesUsed() and BytesAllocated() then describe
+  /// the arena afresh; AllocationCount() keeps counting.
+  void Reset();
+
+  template <typename T>
+  T* Allocate(const std::size_t count)
+  {
+    return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  /// Number of chunks requested from the heap over the arena's lifetime. Reset() does not clear
+  /// it, so the difference between two calls counts the chunks a reused arena had to add.
+  [[nodiscard]] std::size_t AllocationCount() const { return m_allocations; }
+
+  /// Total size of the chunks the arena holds now.
+  [[nodiscard]] std::size_t BytesAllocated() const { return m_bytesAllocated; }
+
+  /// Total size of all allocations handed out so far.
+  [[nodiscard]] std::size_t BytesUsed() const { return m_bytesUsed; }
+
+private:
+  struct Chunk
+  {
+    Chunk* next;
+    std::size_t capacity;
+  };
+
+  Chunk* m_chunks = nullptr;
+  char* m_cursor = nullptr;
+  char* m_end = nullptr;
+  std::size_t m_nextChunkSize = 4096;
+  std::size_t m_allocations = 0;
+  std::size_t m_bytesAllocated = 0;
+  std::size_t m_bytesUsed = 0;
+
+  void AddChunk(std::size_t minimumBytes);
+  void Release();
+};
+
+/**
+ * @struct JSONKey
+ * @brief A handle to an interned object key.
+ *
+ * Keys interned in the same KeyTable are equal exactly when their handles point at
+ * the same characters, so looking a member up by JSONKey is a pointer compare.
+ */
+struct JSONKey
+{
+  std::string_view name;
+
+  [[nodiscard]] bool IsValid() const { return name.data() != nullptr; }
+};
+
+/**
+ * @class KeyTable
+ * @brief Stores every distinct object key once.
+ *
+ * Each JSONDocument interns its keys in its own table by default. A table can also be
+ * shared across parses through ParseOptions::keyTable, in which case it must outlive
+ * every document parsed with it. A table is not safe to share between threads that
+ * parse at the same time.
+ */
+class KeyTable
+{
+public:
+  /// Return the canonical copy of `key`, storing it on first use.
+  JSONKey Intern(std::string_view key);
+
+  /// Return the canonical copy of `key`, or an invalid handle if it was never interned.
+  [[nodiscard]] JSONKey Find(std::string_view key) const;
+
+  /// Forget every key but keep the table's memory for reuse.
+  void Clear();
+
+  /// Number of distinct keys stored.
+  [[nodiscard]] std::size_t Size() const { return m_count; }
+  [[nodiscard]] std::size_t BytesUsed() const { return m_arena.BytesUsed(); }
+  [[nodiscard]] std::size_t AllocationCount() const { return m_arena.AllocationCount() + m_rehashes; }
+  [[nodiscard]] std::size_t ArenaAllocationCount() const { return m_arena.AllocationCount(); }
+
+private:
+  Arena m_arena;
+  std::vector<std::string_view> m_slots; // Open addressing, null data marks a free slot
+  std::size_t m_count = 0;
+  std::size_t m_rehashes = 0;
+};
+
+/**
+ * @enum JSONType
+ * @brief The kind of value stored in a JSONNode.
+ */
+enum class JSONType : uint8_t
+{
+  Null,
+  Double,
+  Bool,
+  String,
+  Array,
+  Object,
+  Int64,
+  UInt64
+};
+
+struct JSONMember;
+
+/**
+ * @struct JSONNode
+ * @brief A read-only JSON value stored inside a JSONDocument's arena.
+ *
+ * Nodes are trivially destructible. Strings, array elements and object members
+ * all live in the owning document's arena, so a node is only valid as long as
+ * its document is alive. The accessors mirror the ones on JSONValue.
+ */
+struct JSONNode
+{
+  JSONType type = JSONType::Null;
+  uint32_t size = 0; // String length, element count or member count
+
+  union
+  {
+    double number;
+    int64_t integer;
+    uint64_t unsignedInteger;
+    bool boolean;
+    const char* string;
+    const JSONNode* elements;
+    const JSONMember* members;
+  };
+
+  JSONNode() : number(0.0) {}
+
+  static const JSONNode nullNode;
+
+  // Helpers to determine the type of data.
+  [[nodiscard]] bool IsNull() const { return type == JSONType::Null; }
+  [[nodiscard]] bool IsDouble() const { return type == JSONType::Double; }
+  [[nodiscard]] bool IsInt64() const { return type == JSONType::Int64; }
+  [[nodiscard]] bool IsUInt64() const { return type == JSONType::UInt64; }
+  [[nodiscard]] bool IsNumber() const { return IsDouble() || IsInt64() || IsUInt64(); }
+  [[nodiscard]] bool IsBool() const { return type == JSONType::Bool; }
+  [[nodiscard]] bool IsString() const { return type == JSONType::String; }
+  [[nodiscard]] bool IsJSONArray() const { return type == JSONType::Array; }
+  [[nodiscard]] bool IsJSONObject() const { return type == JSONType::Object; }
+
+  /// Number of elements or members. Throws an error if the node is not a container.
+  [[nodiscard]] std::size_t Size() const
+  {
+    if (!IsJSONArray() && !IsJSONObject()) throw std::runtime_error("Cannot take the size of a non-container JSON value");
+    return size;
+  }
+
+  /// Return a reference to the element at the given index.
+  /// Throws an error if the node is not an array.
+  /// @warning Returns the null node if the index is invalid
+  const JSONNode& operator[](int index) const;
+
+  /// Return a reference to the member with the given key, the last one if the key is repeated.
+  /// Throws an error if the node is not an object.
+  /// @warning Returns the null node if the key is not present
+  const JSONNode& operator[](std::string_view key) const;
+  const JSONNode& operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+  /// Return a reference to the member with the given interned key, comparing key pointers only,
+  /// and the last one if the key is repeated. The key must come from the table the document was parsed with, see JSONDocument::Key().
+  /// Throws an error if the node is not an object.
+  /// @warning Returns the null node if the key is not present
+  const JSONNode& operator[](const JSONKey& key) const;
+
+  /// Return the elements of an array. Throws an error if the node is not an array.
+  [[nodiscard]] std::span<const JSONNode> Elements() const;
+
+  /// Return the members of an object in document order, with a repeated key once per occurrence.
+  /// Throws an error if the node is not an object.
+  [[nodiscard]] std::span<const JSONMember> Members() const;
+
+  [[nodiscard]] std::string_view AsString() const
+  {
+    if (IsNull()) return {};
+    if (!IsString()) throw std::runtime_error("Cannot convert non-string JSON value to string");
+    return {string, size};
+  }
+
+  [[nodiscard]] double AsDouble() const
+  {
+    if (IsNull()) return 0.0;
+    if (IsInt64()) return static_cast<double>(integer);
+    if (IsUInt64()) return static_cast<double>(unsignedInteger);
+    if (!IsDouble()) throw std::runtime_error("Cannot convert non-double JSON value to double");
+    return number;
+  }
+
+  [[nodiscard]] int AsInt() const { return IsInt64() ? static_cast<int>(integer) : static_cast<int>(AsDouble()); }
+
+  /// Return the number as a signed 64-bit integer, exactly if it was written as one.
+  /// Throws an error if the node is not a number or an unsigned integer does not fit.
+  [[nodiscard]] int64_t AsInt64() const;
+
+  /// Return the number as an unsigned 64-bit integer, exactly if it was written as one.
+  /// Throws an error if the node is not a number or is a negative integer.
+  [[nodiscard]] uint64_t AsUInt64() const;
+
+  [[nodiscard]] bool AsBool() const
+  {
+    if (IsNull()) return false;
+    if (!IsBool()) throw std::runtime_error("Cannot convert non-bool JSON value to bool");
+    return boolean;
+  }
+
+  /// Deep copy the node into an owning JSONValue.
+  [[nodiscard]] JSONValue ToJSONValue() const;
+};
+inline const JSONNode JSONNode::nullNode = {};
+
+/**
+ * @struct JSONMember
+ * @brief A key/value pair of a JSONNode object, in document order.
+ */
+struct JSONMember
+{
+  std::string_view key; // Interned, see KeyTable
+  JSONNode value;
+};
+
+/**
+ * @class JSONDocument
+ * @brief Owns the arena that every node, key and string of a parsed document lives in.
+ *
+ * Parsing into a document performs a small, constant number of heap allocations
+ * (the arena chunks) instead of one per string, array and object, and destroying
+ * it releases everything in one step. Object keys are interned, so every distinct
+ * key is stored once per document. Parsing into a document that was used before,
+ * see JSONParser, reuses its memory.
+ */
+class JSONDocument
+{
+public:
+  JSONDocument() = default;
+  JSONDocument(JSONDocument&&) noexcept = default;
+  JSONDocument& operator=(JSONDocument&&) noexcept = default;
+
+  [[nodiscard]] const JSONNode& Root() const { return m_root; }
+
+  /// Look up the handle of an object key, for fast repeated lookups with JSONNode::operator[](JSONKey).
+  /// Returns an invalid handle if no object in the document has this key.
+  [[nodiscard]] JSONKey Key(const std::string_view name) const { return Keys().Find(name); }
+
+  /// The table this document's keys are interned in.
+  [[nodiscard]] const KeyTable& Keys() const { return m_sharedKeys != nullptr ? *m_sharedKeys : m_keys; }
+
+  /// Number of heap allocations made to store the document: arena chunks and key table growth.
+  /// Scratch memory the parser needs while building the document is not included. The count
+  /// keeps growing when the document is reused for another parse.
+  [[nodiscard]] std::size_t AllocationCount() const { return m_arena.AllocationCount() + m_keys.AllocationCount(); }
+
+  /// Number of arena chunks taken from malloc directly. Unlike every other allocation of a
+  /// parse, these do not go through operator new.
+  [[nodiscard]] std::size_t ArenaAllocationCount() const { return m_arena.AllocationCount() + m_keys.ArenaAllocationCount(); }
+  [[nodiscard]] std::size_t BytesAllocated() const { return m_arena.BytesAllocated(); }
+  [[nodiscard]] std::size_t BytesUsed() const { return m_arena.BytesUsed() + m_keys.BytesUsed(); }
+
+private:
+  friend class Parser;
+  friend class JSON;
+
+  /// Empty the document for the next parse while keeping its arena and key table memory.
+  void Reset();
+
+  Arena m_arena;
+  KeyTable m_keys;
+  KeyTable* m_sharedKeys = nullptr;
+  JSONNode m_root;
+
+  // Keeps the parsed input alive (e.g. a file mapping) while strings point into it.
+  std::shared_ptr<const void> m_source;
+};
@@ -0,0 +1,92 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct JSONValue;
+class JSONObjectMember;
+
+/**
+ * @class JSONObject
+ * @brief The member storage of a JSON object: a contiguous, insertion-ordered list of key/value pairs.
+ *
+ * It offers the subset of the std::map interface that JSONValue exposes through AsObject(),
+ * but keeps members in one vector, so iteration is a linear walk and members keep the order
+ * they were inserted in. Small objects are searched linearly. Once an object grows past
+ * IndexThreshold members, a hash index over the keys is built and maintained on insertion.
+ * Members are JSONObjectMember pairs, whose keys can be read but not changed from outside.
+ */
+class JSONObject
+{
+public:
+  using value_type = JSONObjectMember;
+  using iterator = std::vector<value_type>::iterator;
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  static constexpr std::size_t IndexThreshold = 8;
+
+  JSONObject();
+  JSONObject(const JSONObject& other);
+  JSONObject(JSONObject&& other) noexcept;
+  JSONObject& operator=(const JSONObject& other);
+  JSONObject& operator=(JSONObject&& other) noexcept;
+  ~JSONObject();
+
+  [[nodiscard]] iterator begin();
+  [[nodiscard]] iterator end();
+  [[nodiscard]] const_iterator begin() const;
+  [[nodiscard]] const_iterator end() const;
+
+  [[nodiscard]] std::size_t size() const { return m_members.size(); }
+  [[nodiscard]] bool empty() const { return m_members.empty(); }
+  void reserve(std::size_t count) { m_members.reserve(count); }
+  [[nodiscard]] std::size_t capacity() const { return m_members.capacity(); }
+  void clear();
+
+  [[nodiscard]] iterator find(std::string_view key);
+  [[nodiscard]] const_iterator find(std::string_view key) const;
+
+  /// Look up a key whose Hash() was computed ahead of time, e.g. by a compiled JSONPath.
+  [[nodiscard]] const_iterator find(std::string_view key, std::size_t hash) const;
+  [[nodiscard]] bool contains(std::string_view key) const { return Find(key) != NotFound; }
+  [[nodiscard]] std::size_t count(std::string_view key) const { return contains(key) ? 1 : 0; }
+
+  /// Return the value for `key`. Throws std::out_of_range if the key is not present.
+  [[nodiscard]] JSONValue& at(std::string_view key);
+  [[nodiscard]] const JSONValue& at(std::string_view key) const;
+
+  /// Return the value for `key`, appending a null value if the key is not present.
+  JSONValue& operator[](std::string_view key);
+  JSONValue& operator[](std::string&& key);
+
+  /// Append a member if `key` is not present yet. Returns the member and whether it was inserted.
+  std::pair<iterator, bool> emplace(std::string key, JSONValue value);
+
+  /// The hash the index uses for `key`.
+  [[nodiscard]] static std::size_t Hash(std::string_view key);
+
+  /// Remove the member with the given key, keeping the order of the others. Returns the number removed.
+  std::size_t erase(std::string_view key);
+
+private:
+  static constexpr uint32_t NotFound = ~0u;
+
+  std::vector<value_type> m_members;
+
+  // Open-addressing table of member index + 1 (0 marks a free slot). Empty until the
+  // object passes IndexThreshold members.
+  std::vector<uint32_t> m_index;
+
+  [[nodiscard]] uint32_t Find(std::string_view key) const;
+  [[nodiscard]] uint32_t Scan(std::string_view key) const;
+  [[nodiscard]] uint32_t Probe(std::string_view key, std::size_t hash) const;
+  JSONValue& Append(std::string&& key);
+  void Insert(uint32_t member);
+  void Rehash(std::size_t slots);
+};
@@ -0,0 +1,66 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSON.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class JSONParser
+ * @brief A long-lived parser that keeps its memory from one parse to the next.
+ *
+ * JSON::ParseDocument and JSON::ParseTape build their output and scratch space from scratch
+ * on every call. A JSONParser instead keeps its nesting stacks and key scratch buffer, and
+ * parsing into the same JSONDocument or JSONTape again reuses the output's memory too. Once
+ * the buffers have grown to fit the largest message, parsing makes no heap allocation at all:
+ *
+ * @code
+ * JSONParser parser;
+ * JSONDocument document;
+ * for (std::string_view message : messages)
+ * {
+ *   parser.Parse(message, document); // Invalidates the nodes of the previous message
+ *   Handle(document.Root());
+ * }
+ * @endcode
+ *
+ * Parsing into an output invalidates every node or element previously read from it.
+ * A JSONParser is not safe to use from several threads at once; use one per thread.
+ */
+class JSONParser
+{
+public:
+  JSONParser() = default;
+
+  /// Parse `source` into `document`, replacing its content. Throws std::runtime_error if it is not valid JSON.
+  void Parse(std::string_view source, JSONDocument& document, const ParseOptions& options = {});
+
+  /// Parse `source` onto `tape`, replacing its content. Throws std::runtime_error if it is not valid JSON.
+  void Parse(std::string_view source, JSONTape& tape, const ParseOptions& options = {});
+
+  /// Bytes currently reserved by the parser's own buffers, excluding the outputs.
+  [[nodiscard]] std::size_t BytesAllocated() const
+  {
+    return m_frameStack.capacity() * sizeof(NodeFrame) + m_nodeStack.capacity() * sizeof(JSONNode) +
+           m_memberStack.capacity() * sizeof(JSONMember) + m_scratch.capacity();
+  }
+
+private:
+  friend class Parser;
+
+  // A container the document parse has opened but not closed yet.
+  struct NodeFrame
+  {
+    std::size_t base;     // Size of the node or member stack when it was opened
+    std::string_view key; // Key of the object member being parsed
+    bool isObject;
+  };
+
+  std::vector<NodeFrame> m_frameStack;
+  std::vector<JSONNode> m_nodeStack;
+  std::vector<JSONMember> m_memberStack;
+  std::string m_scratch;
+};
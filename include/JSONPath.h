@@ -0,0 +1,102 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSON.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Lexer;
+struct Token;
+
+/**
+ * @class JSONPath
+ * @brief A path expression that is compiled once and evaluated against many documents.
+ *
+ * Two syntaxes are accepted:
+ * - A JSON Pointer (RFC 6901), e.g. `/payload/items/3/price`. `~1` stands for '/' and `~0` for '~'.
+ *   A numeric token selects an array element or, in an object, the member with that name.
+ * - A JSONPath subset starting with `$`, e.g. `$.payload.items[3].price`. Members are selected
+ *   with `.name` or `['name']`, elements with `[3]`, all members or elements with `.*` or `[*]`,
+ *   and a range of elements with a slice `[begin:end]` (either bound may be omitted).
+ *
+ * Compiling parses the array indices and precomputes the hash of every key, so an evaluation
+ * neither allocates nor hashes. A path that does not match a document simply selects nothing;
+ * there are no exceptions for missing keys or for indexing a value of the wrong type.
+ * A key that occurs more than once in an object selects its last value, in raw text as in a
+ * parsed tree. A wildcard over raw text still visits every occurrence.
+ *
+ * @code
+ * const JSONPath prices("$.payload.items[*].price");
+ * prices.Select(root, [](const JSONValue& price) { total += price.AsDouble(); });
+ * @endcode
+ */
+class JSONPath
+{
+public:
+  /// Compile `expression`. Throws std::runtime_error if it is not a valid path.
+  explicit JSONPath(std::string_view expression);
+
+  /// Number of steps from the root to the selected values.
+  [[nodiscard]] std::size_t Size() const { return m_steps.size(); }
+
+  /// True if the path contains no wildcard or slice, so it selects at most one value.
+  [[nodiscard]] bool IsSingular() const { return m_singular; }
+
+  /// Return the first selected value in a tree, or a null value if there is none.
+  [[nodiscard]] const JSONValue& Get(const JSONValue& root) const;
+
+  /// Return a cursor to the first selected value in raw JSON text, or a missing cursor.
+  /// Only the containers on the path are lexed; everything else is skipped. For raw text, only
+  /// `options.validateUTF8` applies, to the strings that are lexed.
+  [[nodiscard]] JSONCursor Get(std::string_view source, const ParseOptions& options = {}) const;
+
+  /// Call `callback` for every selected value, in document order.
+  void Select(const JSONValue& root, const std::function<void(const JSONValue&)>& callback) const;
+  void Select(std::string_view source, const std::function<void(const JSONCursor&)>& callback,
+              const ParseOptions& options = {}) const;
+
+  /// Collect every selected value. The pointers and cursors refer into `root` and `source`.
+  [[nodiscard]] std::vector<const JSONValue*> SelectAll(const JSONValue& root) const;
+  [[nodiscard]] std::vector<JSONCursor> SelectAll(std::string_view source, const ParseOptions& options = {}) const;
+
+private:
+  static constexpr std::size_t NoIndex = ~std::size_t{0};
+
+  enum class StepKind
+  {
+    Member,   // An object member; also an array element if `begin` holds its index
+    Index,    // An array element
+    Wildcard, // Every member or element
+    Slice     // The elements from `begin` up to, but not including, `end`
+  };
+
+  struct Step
+  {
+    StepKind kind;
+    std::string key;
+    std::size_t hash = 0;
+    std::size_t begin = NoIndex;
+    std::size_t end = NoIndex;
+  };
+
+  std::vector<Step> m_steps;
+  bool m_singular = true;
+
+  void CompilePointer(std::string_view expression);
+  void CompilePath(std::string_view expression);
+  void AddMember(std::string key);
+
+  template <typename Visitor>
+  bool Visit(const JSONValue& value, std::size_t step, Visitor& visitor) const;
+
+  template <typename Visitor>
+  bool Visit(Lexer& lexer, const Token& first, std::string_view source, bool validateUTF8, std::size_t step, Visitor& visitor) const;
+
+  template <typename Visitor>
+  void VisitSource(std::string_view source, bool validateUTF8, Visitor& visitor) const;
+};
@@ -0,0 +1,227 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSON.h"
+#include "JSONTokenizer.h"
+#include <concepts>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @concept JSONHandler
+ * @brief The callbacks a SAX handler must provide.
+ *
+ * Strings and keys are passed already unescaped. The views are only valid for the
+ * duration of the callback.
+ *
+ * A handler that also provides OnInt64(int64_t) and OnUInt64(uint64_t) receives integers
+ * through those, exactly. Otherwise every number is passed to OnNumber as a double.
+ */
+template <typename Handler>
+concept JSONHandler = requires(Handler& handler, std::string_view text, double number, bool boolean)
+{
+  handler.OnObjectStart();
+  handler.OnKey(text);
+  handler.OnObjectEnd();
+  handler.OnArrayStart();
+  handler.OnArrayEnd();
+  handler.OnString(text);
+  handler.OnNumber(number);
+  handler.OnBool(boolean);
+  handler.OnNull();
+};
+
+/**
+ * @class SAXParser
+ * @brief Drives a handler with events straight from a JSONTokenizer, without building any tree.
+ *
+ * The handler is a template parameter, so its callbacks are dispatched statically and
+ * can be inlined into the parse loop.
+ *
+ * @code
+ * struct Counter
+ * {
+ *   int numbers = 0;
+ *   void OnNumber(double) { numbers++; }
+ *   // ... the remaining callbacks
+ * };
+ * Counter counter;
+ * SAXParser<Counter>::Parse(source, counter);
+ * @endcode
+ */
+template <JSONHandler Handler>
+class SAXParser
+{
+public:
+  /**
+   * @brief Parses the source and reports every value to the handler in document order.
+   *
+   * @param source The JSON-encoded text to parse.
+   * @param handler Receives the events.
+   * @param options Settings for the parse. Only `options.maxDepth` and `options.validateUTF8` apply.
+   * @throws std::runtime_error If the input is not valid JSON, nests deeper than `options.maxDepth`
+   *         or, when validation is on, contains a string that is not valid UTF-8.
+   *         Events up to the error have been delivered.
+   */
+  static void Parse(const std::string_view source, Handler& handler, const ParseOptions& options = {})
+  {
+    SAXParser instance(source, handler, options.validateUTF8);
+    instance.m_maxDepth = options.maxDepth;
+
+    if (instance.m_current.type == TokenType::END_OF_FILE) return;
+
+    instance.ParseValue();
+
+    if (instance.m_current.type != TokenType::END_OF_FILE)
+    {
+      throw std::runtime_error("Unexpected data after end of JSON");
+    }
+  }
+
+private:
+  SAXParser(const std::string_view source, Handler& handler, const bool validateUTF8)
+    : m_lexer(source, validateUTF8), m_current(m_lexer.NextToken()), m_handler(handler) {}
+
+  JSONTokenizer m_lexer;
+  Token m_current;
+  Handler& m_handler;
+  std::string m_scratch;
+  std::vector<bool> m_objects; // Kinds of the open containers, true for an object
+  std::size_t m_depth = 0;
+  std::size_t m_maxDepth = ParseOptions::DefaultMaxDepth;
+
+  void Next() { m_current = m_lexer.NextToken(); }
+
+  void Expect(const TokenType type) const
+  {
+    if (m_current.type != type) throw std::runtime_error("Unexpected token type");
+  }
+
+  /// The depth limit bounds the stack of open containers, which lives on the heap.
+  void Descend()
+  {
+    if (++m_depth > m_maxDepth) throw JSONTokenizer::DepthError(m_maxDepth);
+  }
+
+  /// Return the decoded string, a view into the source if it has no escapes.
+  std::string_view Decode(const Token& token)
+  {
+    if (!token.escaped) return token.value;
+    m_scratch.resize(token.value.size());
+    m_scratch.resize(JSONTokenizer::Unescape(token.value, m_scratch.data()));
+    return m_scratch;
+  }
+
+  /**
+   * Reports the next value, and everything nested inside it. Containers do not recurse: the
+   * kinds of the open ones wait on m_objects, innermost last.
+   */
+  void ParseValue()
+  {
+    while (true)
+    {
+      const Token token = m_current;
+
+      switch (token.type)
+      {
+        case TokenType::LEFT_BRACE:
+        case TokenType::LEFT_BRACKET:
+          {
+            Next(); // Eat beginning brace or bracket
+            Descend();
+            const bool isObject = token.type == TokenType::LEFT_BRACE;
+            m_objects.push_back(isObject);
+            if (isObject) m_handler.OnObjectStart();
+            else m_handler.OnArrayStart();
+            if (!NextChild(true)) continue; // Go on with the first child
+
+            Close(); // Empty container
+            break;
+          }
+        case TokenType::STRING: Next(); m_handler.OnString(Decode(token)); break;
+        case TokenType::INT:
+        case TokenType::DOUBLE: Next(); ReportNumber(token); break;
+        case TokenType::TRUE: Next(); m_handler.OnBool(true); break;
+        case TokenType::FALSE: Next(); m_handler.OnBool(false); break;
+        case TokenType::NULL_TYPE: Next(); m_handler.OnNull(); break;
+        default: throw std::runtime_error("Unexpected token type" + std::string(token.value));
+      }
+
+      // Close every container that ends after the value just reported.
+      while (true)
+      {
+        if (m_objects.empty()) return;
+        if (!NextChild(false)) break; // Go on with the next child
+
+        Close();
+      }
+    }
+  }
+
+  /**
+   * Reads the comma after the innermost open container's previous child, unless `first` is set,
+   * and checks whether the container ends here. Otherwise, for an object, reports the next key.
+   *
+   * @return True if the container's closing token was read.
+   */
+  bool NextChild(const bool first)
+  {
+    const bool isObject = m_objects.back();
+    const TokenType close = isObject ? TokenType::RIGHT_BRACE : TokenType::RIGHT_BRACKET;
+
+    if (!first && m_current.type != close)
+    {
+      Expect(TokenType::COMMA);
+      Next();
+    }
+
+    if (m_current.type == close)
+    {
+      Next(); // Eat the ending brace or bracket
+      return true;
+    }
+
+    if (isObject)
+    {
+      Expect(TokenType::STRING);
+      m_handler.OnKey(Decode(m_current));
+      Next();
+
+      Expect(TokenType::COLON);
+      Next();
+    }
+    return false;
+  }
+
+  /// Pops the innermost open container and reports its end.
+  void Close()
+  {
+    const bool isObject = m_objects.back();
+    m_objects.pop_back();
+    m_depth--;
+    if (isObject) m_handler.OnObjectEnd();
+    else m_handler.OnArrayEnd();
+  }
+
+  void ReportNumber(const Token& token)
+  {
+    const ParsedNumber number = JSONTokenizer::ParseNumber(token);
+
+    if constexpr (requires { m_handler.OnInt64(int64_t{}); m_handler.OnUInt64(uint64_t{}); })
+    {
+      if (number.type == JSONType::Int64) { m_handler.OnInt64(number.integer); return; }
+      if (number.type == JSONType::UInt64) { m_handler.OnUInt64(number.unsignedInteger); return; }
+    }
+
+    switch (number.type)
+    {
+      case JSONType::Int64: m_handler.OnNumber(static_cast<double>(number.integer)); return;
+      case JSONType::UInt64: m_handler.OnNumber(static_cast<double>(number.unsignedInteger)); return;
+      default: m_handler.OnNumber(number.number); return;
+    }
+  }
+};
@@ -0,0 +1,127 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct JSONValue;
+struct JSONSnapshotImage;
+
+/**
+ * @class JSONSnapshotValue
+ * @brief A read-only handle to a value inside a binary snapshot.
+ *
+ * A handle is 24 bytes and reads straight from the snapshot's memory: strings are views
+ * into it, and looking up a key is a binary search over the object's sorted keys. Handles
+ * are only valid as long as the JSONSnapshot they came from, or a copy of it, is alive.
+ * The accessors mirror the ones on JSONNode.
+ */
+class JSONSnapshotValue
+{
+public:
+  JSONSnapshotValue() = default;
+
+  // Helpers to determine the type of data.
+  [[nodiscard]] bool IsNull() const { return m_type == Null; }
+  [[nodiscard]] bool IsDouble() const { return m_type == Double; }
+  [[nodiscard]] bool IsInt64() const { return m_type == Int64; }
+  [[nodiscard]] bool IsUInt64() const { return m_type == UInt64; }
+  [[nodiscard]] bool IsNumber() const { return IsDouble() || IsInt64() || IsUInt64(); }
+  [[nodiscard]] bool IsBool() const { return m_type == Bool; }
+  [[nodiscard]] bool IsString() const { return m_type == String; }
+  [[nodiscard]] bool IsJSONArray() const { return m_type == Array; }
+  [[nodiscard]] bool IsJSONObject() const { return m_type == Object; }
+
+  /// Number of elements or members. Throws an error if the value is not a container.
+  [[nodiscard]] std::size_t Size() const;
+
+  /// Return the element at the given index.
+  /// Throws an error if the value is not an array.
+  /// @warning Returns a null value if the index is invalid
+  JSONSnapshotValue operator[](int index) const;
+
+  /// Return the member with the given key.
+  /// Throws an error if the value is not an object.
+  /// @warning Returns a null value if the key is not present
+  JSONSnapshotValue operator[](std::string_view key) const;
+  JSONSnapshotValue operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+  /// Key and value of the member at `index`. Members are sorted by key, not in document order.
+  /// Throws an error if the value is not an object or the index is out of range.
+  [[nodiscard]] std::string_view KeyAt(std::size_t index) const;
+  [[nodiscard]] JSONSnapshotValue ValueAt(std::size_t index) const;
+
+  [[nodiscard]] std::string_view AsString() const;
+  [[nodiscard]] double AsDouble() const;
+  [[nodiscard]] int AsInt() const { return IsInt64() ? static_cast<int>(AsInt64()) : static_cast<int>(AsDouble()); }
+  [[nodiscard]] int64_t AsInt64() const;
+  [[nodiscard]] uint64_t AsUInt64() const;
+  [[nodiscard]] bool AsBool() const;
+
+  /// Deep copy the value into an owning JSONValue.
+  [[nodiscard]] JSONValue ToJSONValue() const;
+
+private:
+  friend class JSONSnapshot;
+
+  // Same values as JSONType
+  enum : uint8_t { Null, Double, Bool, String, Array, Object, Int64, UInt64 };
+
+  const JSONSnapshotImage* m_image = nullptr;
+  uint8_t m_type = Null;
+  uint32_t m_size = 0;    // Element or member count, or string index
+  uint64_t m_payload = 0; // Number bits, or the offset of a container's body
+
+  static JSONSnapshotValue Load(const JSONSnapshotImage* image, uint64_t offset);
+};
+
+/**
+ * @class JSONSnapshot
+ * @brief A parsed document saved in a compact binary form that is navigated without being decoded.
+ *
+ * JSON::SaveBinary writes the snapshot; JSON::LoadBinary maps it back into memory and checks
+ * its header, which takes the same time however large the document is. Nothing is parsed or
+ * copied afterwards: every lookup reads the mapping directly, so only the pages that are
+ * actually visited are ever read from disk.
+ *
+ * Layout (in native byte order, everything aligned to 8 bytes):
+ * - A header with the root value and the position of the string table.
+ * - Values as 8-byte slots: a tag and either the value itself (bools, strings as an index
+ *   into the string table, integers that fit in 32 bits) or the position of a 64-bit number
+ *   or of a container's body.
+ * - Array bodies: the element count, then one slot per element. Object bodies: the member
+ *   count, the string index of every key sorted by the keys' bytes, then one slot per member
+ *   in the same order.
+ * - The string table: the end offset of every string, then their bytes. Every distinct key
+ *   and string value is stored once.
+ */
+class JSONSnapshot
+{
+public:
+  JSONSnapshot() = default;
+
+  [[nodiscard]] JSONSnapshotValue Root() const;
+
+  /// Number of distinct strings (keys and values) in the snapshot.
+  [[nodiscard]] std::size_t StringCount() const;
+
+  /// Size of the snapshot in bytes.
+  [[nodiscard]] std::size_t Size() const;
+
+  /// Encode `value` as a snapshot.
+  static std::string Encode(const JSONValue& value);
+
+  /// Navigate a snapshot held in memory, e.g. one returned by Encode(). `data` must be aligned
+  /// to 8 bytes and stay alive and unchanged while the snapshot is used; `owner`, if given,
+  /// is kept alive for that long. Throws std::runtime_error if the data is not a valid snapshot.
+  static JSONSnapshot View(std::string_view data, std::shared_ptr<const void> owner = nullptr);
+
+private:
+  // Shared, so copies of the snapshot are cheap and handles stay valid when it is moved.
+  std::shared_ptr<const JSONSnapshotImage> m_image;
+};
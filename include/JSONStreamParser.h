@@ -0,0 +1,101 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSON.h"
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Token;
+
+/**
+ * @class JSONStreamParser
+ * @brief A resumable parser that accepts a document in arbitrary chunks.
+ *
+ * Feed() tokenizes and builds as much of the value as the bytes received so far allow.
+ * Bytes of a token that is cut off by the end of a chunk (mid-string, mid-escape,
+ * mid-number or mid-literal) are kept until the next chunk completes it, and the stack
+ * of containers under construction is kept between calls. Several values may follow
+ * each other in the stream, as in newline-delimited JSON; each one is queued as soon
+ * as it is complete. Containers nested deeper than ParseOptions::maxDepth are rejected,
+ * as they are by JSON::Parse.
+ *
+ * @code
+ * JSONStreamParser parser;
+ * while (receive(chunk))
+ * {
+ *   if (parser.Feed(chunk)) handle(parser.TakeValue());
+ * }
+ * parser.Finish();
+ * @endcode
+ *
+ * After an exception the parser must be Reset() before it is fed again.
+ */
+class JSONStreamParser
+{
+public:
+  /// Only `options.maxDepth` and `options.validateUTF8` apply.
+  explicit JSONStreamParser(const ParseOptions& options = {})
+    : m_maxDepth(options.maxDepth), m_validateUTF8(options.validateUTF8) {}
+
+  /**
+   * @brief Parses the next chunk of input.
+   * @return True if at least one complete value is ready to be taken.
+   * @throws std::runtime_error If the input is not valid JSON, nests deeper than the maximum depth
+   *         or, when validation is on, contains a string that is not valid UTF-8.
+   */
+  bool Feed(std::string_view chunk);
+
+  /**
+   * @brief Marks the end of the input, completing a trailing top-level number or literal.
+   * @return True if at least one complete value is ready to be taken.
+   * @throws std::runtime_error If the input ends inside a value.
+   */
+  bool Finish();
+
+  [[nodiscard]] bool HasValue() const { return !m_values.empty(); }
+
+  /// Remove and return the oldest complete value. Throws an error if there is none.
+  JSONValue TakeValue();
+
+  /// Current nesting depth of the value under construction.
+  [[nodiscard]] std::size_t Depth() const { return m_stack.size(); }
+
+  /// Drop all buffered input, partial values and queued values.
+  void Reset();
+
+private:
+  enum class State
+  {
+    Value,        // A value must follow
+    ValueOrEnd,   // After '[' or ',' in an array
+    KeyOrEnd,     // After '{' or ',' in an object
+    Colon,        // After a key
+    CommaOrEnd    // After a member or element
+  };
+
+  struct Frame
+  {
+    JSONValue container;
+    std::string key;
+  };
+
+  std::size_t m_maxDepth;
+  bool m_validateUTF8;
+  std::string m_buffer;       // Start of a token cut off by the end of the last chunk
+  std::size_t m_scanFrom = 0; // How far an unterminated string in m_buffer has been searched
+  bool m_inString = false;
+  State m_state = State::Value;
+  std::vector<Frame> m_stack;
+  std::deque<JSONValue> m_values;
+
+  bool StringClosed();
+  void Lex(bool final);
+  void Consume(const Token& token);
+  void BeginValue(const Token& token);
+  void Close(bool array);
+  void Complete(JSONValue&& value);
+};
@@ -0,0 +1,264 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSONDocument.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+struct JSONValue;
+
+/**
+ * @namespace JSONTapeDetail
+ * @brief The encoding of a JSONTape's words. Only needed by the parser and JSONElement.
+ *
+ * Every word holds a tag in its top byte and a 56-bit payload:
+ * - Null, and Bool with the value (0 or 1) as payload.
+ * - String with the offset of the string in the string buffer as payload. The buffer holds
+ *   the string's length as a 4-byte integer followed by its bytes.
+ * - Double, Int64 and UInt64, whose payload is unused. The next word holds the number's bits.
+ * - Array and Object, whose payload holds the number of children in bits 32-55 (saturated at
+ *   MaxCount) and the index of the word just past the container in bits 0-31. They are matched
+ *   by an ArrayEnd or ObjectEnd word whose payload is the index of the opening word.
+ * Object members are stored as a String word for the key followed by the value.
+ */
+namespace JSONTapeDetail
+{
+  // Same values as JSONType for the value tags
+  enum Tag : uint8_t { Null, Double, Bool, String, Array, Object, Int64, UInt64, ArrayEnd, ObjectEnd };
+
+  constexpr uint64_t PayloadMask = (uint64_t{1} << 56) - 1;
+  constexpr uint64_t MaxCount = 0xFFFFFF;
+
+  constexpr uint64_t MakeWord(const Tag tag, const uint64_t payload) { return (uint64_t{tag} << 56) | payload; }
+  constexpr uint8_t TagOf(const uint64_t word) { return static_cast<uint8_t>(word >> 56); }
+  constexpr uint64_t PayloadOf(const uint64_t word) { return word & PayloadMask; }
+}
+
+struct JSONTapeMember;
+
+/**
+ * @class JSONElement
+ * @brief A read-only handle to a value on a JSONTape.
+ *
+ * A handle is three words and reads straight from the tape: children follow their
+ * container, so walking a document touches memory strictly front to back. Every container
+ * links to its end, so a child that is not of interest is skipped in one step. Finding an
+ * element or member walks the children before it. Handles stay valid while the tape they
+ * came from is alive, also when the tape is moved. The accessors mirror the ones on JSONNode.
+ */
+class JSONElement
+{
+public:
+  class Iterator;
+  class MemberIterator;
+
+  /// A pair of iterators over the children of a container, for range-based for loops.
+  template <typename It>
+  struct Range
+  {
+    It first;
+    It last;
+    [[nodiscard]] It begin() const { return first; }
+    [[nodiscard]] It end() const { return last; }
+  };
+
+  JSONElement() = default;
+
+  // Helpers to determine the type of data.
+  [[nodiscard]] bool IsNull() const { return Tag() == JSONTapeDetail::Null; }
+  [[nodiscard]] bool IsDouble() const { return Tag() == JSONTapeDetail::Double; }
+  [[nodiscard]] bool IsInt64() const { return Tag() == JSONTapeDetail::Int64; }
+  [[nodiscard]] bool IsUInt64() const { return Tag() == JSONTapeDetail::UInt64; }
+  [[nodiscard]] bool IsNumber() const { return IsDouble() || IsInt64() || IsUInt64(); }
+  [[nodiscard]] bool IsBool() const { return Tag() == JSONTapeDetail::Bool; }
+  [[nodiscard]] bool IsString() const { return Tag() == JSONTapeDetail::String; }
+  [[nodiscard]] bool IsJSONArray() const { return Tag() == JSONTapeDetail::Array; }
+  [[nodiscard]] bool IsJSONObject() const { return Tag() == JSONTapeDetail::Object; }
+
+  /// Number of elements or members. Throws an error if the value is not a container.
+  [[nodiscard]] std::size_t Size() const;
+
+  /// Return the element at the given index.
+  /// Throws an error if the value is not an array.
+  /// @warning Returns a null element if the index is invalid
+  JSONElement operator[](int index) const;
+
+  /// Return the member with the given key, the last one if the key is repeated.
+  /// Throws an error if the value is not an object.
+  /// @warning Returns a null element if the key is not present
+  JSONElement operator[](std::string_view key) const;
+  JSONElement operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+  /// Return the elements of an array. Throws an error if the value is not an array.
+  [[nodiscard]] Range<Iterator> Elements() const;
+
+  /// Return the members of an object in document order. Throws an error if the value is not an object.
+  [[nodiscard]] Range<MemberIterator> Members() const;
+
+  [[nodiscard]] std::string_view AsString() const;
+  [[nodiscard]] double AsDouble() const;
+  [[nodiscard]] int AsInt() const { return IsInt64() ? static_cast<int>(Number()) : static_cast<int>(AsDouble()); }
+  [[nodiscard]] int64_t AsInt64() const;
+  [[nodiscard]] uint64_t AsUInt64() const;
+  [[nodiscard]] bool AsBool() const;
+
+  /// Deep copy the value into an owning JSONValue.
+  [[nodiscard]] JSONValue ToJSONValue() const;
+
+private:
+  friend class JSONTape;
+
+  const uint64_t* m_tape = nullptr; // Null for the element returned by missing lookups
+  const char* m_strings = nullptr;
+  uint32_t m_index = 0;
+
+  JSONElement(const uint64_t* tape, const char* strings, const uint32_t index)
+    : m_tape(tape), m_strings(strings), m_index(index) {}
+
+  [[nodiscard]] uint64_t Word() const { return m_tape == nullptr ? 0 : m_tape[m_index]; }
+  [[nodiscard]] uint8_t Tag() const { return JSONTapeDetail::TagOf(Word()); }
+  [[nodiscard]] uint64_t Number() const { return m_tape[m_index + 1]; }
+
+  /// Index of the word just past this value.
+  [[nodiscard]] uint32_t Next() const
+  {
+    switch (Tag())
+    {
+      case JSONTapeDetail::Array:
+      case JSONTapeDetail::Object: return static_cast<uint32_t>(Word());
+      case JSONTapeDetail::Double:
+      case JSONTapeDetail::Int64:
+      case JSONTapeDetail::UInt64: return m_index + 2;
+      default: return m_index + 1;
+    }
+  }
+
+  /// Index of the closing word of this container, where iteration over its children stops.
+  [[nodiscard]] uint32_t Last() const { return Next() - 1; }
+
+  [[nodiscard]] JSONElement At(const uint32_t index) const { return {m_tape, m_strings, index}; }
+};
+
+/**
+ * @struct JSONTapeMember
+ * @brief A key/value pair of a JSONElement object, in document order.
+ */
+struct JSONTapeMember
+{
+  std::string_view key;
+  JSONElement value;
+};
+
+class JSONElement::Iterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = JSONElement;
+  using difference_type = std::ptrdiff_t;
+
+  Iterator() = default;
+  explicit Iterator(const JSONElement current) : m_current(current) {}
+
+  JSONElement operator*() const { return m_current; }
+  Iterator& operator++() { m_current.m_index = m_current.Next(); return *this; }
+  Iterator operator++(int) { Iterator previous = *this; ++*this; return previous; }
+  bool operator==(const Iterator& other) const { return m_current.m_index == other.m_current.m_index; }
+
+private:
+  JSONElement m_current;
+};
+
+class JSONElement::MemberIterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = JSONTapeMember;
+  using difference_type = std::ptrdiff_t;
+
+  MemberIterator() = default;
+  explicit MemberIterator(const JSONElement key) : m_key(key) {}
+
+  JSONTapeMember operator*() const { return {m_key.AsString(), m_key.At(m_key.m_index + 1)}; }
+  MemberIterator& operator++() { m_key.m_index = m_key.At(m_key.m_index + 1).Next(); return *this; }
+  MemberIterator operator++(int) { MemberIterator previous = *this; ++*this; return previous; }
+  bool operator==(const MemberIterator& other) const { return m_key.m_index == other.m_key.m_index; }
+
+private:
+  JSONElement m_key; // The key's String word; the value follows it
+};
+
+/**
+ * @class JSONTape
+ * @brief A parsed document stored as one contiguous array of 64-bit words and one string buffer.
+ *
+ * JSON::ParseTape writes the document front to back into two buffers sized for the input up
+ * front, so a parse makes two allocations and never moves what it has written. Values are laid
+ * out in document order, which makes a full traversal a linear scan; see JSONTapeDetail for the
+ * encoding. Unlike JSONDocument, nothing points into the source, and object members keep their
+ * document order, including duplicate keys.
+ */
+class JSONTape
+{
+public:
+  JSONTape() = default;
+
+  /// The root value, or a null element if the source was empty.
+  [[nodiscard]] JSONElement Root() const
+  {
+    if (m_words.empty()) return {};
+    return {m_words.data(), m_strings.data(), 0};
+  }
+
+  /// Number of words on the tape.
+  [[nodiscard]] std::size_t Size() const { return m_words.size(); }
+
+  /// Bytes used by the tape and the string buffer.
+  [[nodiscard]] std::size_t BytesUsed() const { return m_words.size() * sizeof(uint64_t) + m_strings.size(); }
+
+  /// Bytes reserved by the tape and the string buffer.
+  [[nodiscard]] std::size_t BytesAllocated() const { return m_words.capacity() * sizeof(uint64_t) + m_strings.capacity(); }
+
+private:
+  friend class Parser;
+
+  // Vectors rather than strings: their storage never moves when the tape is moved, so handles stay valid.
+  std::vector<uint64_t> m_words;
+  std::vector<char> m_strings;
+};
+
+inline std::string_view JSONElement::AsString() const
+{
+  if (IsNull()) return {};
+  if (!IsString()) throw std::runtime_error("Cannot convert non-string JSON value to string");
+  const char* string = m_strings + JSONTapeDetail::PayloadOf(Word());
+  uint32_t length;
+  std::memcpy(&length, string, sizeof(length));
+  return {string + sizeof(length), length};
+}
+
+inline double JSONElement::AsDouble() const
+{
+  switch (Tag())
+  {
+    case JSONTapeDetail::Null:   return 0.0;
+    case JSONTapeDetail::Double: return std::bit_cast<double>(Number());
+    case JSONTapeDetail::Int64:  return static_cast<double>(static_cast<int64_t>(Number()));
+    case JSONTapeDetail::UInt64: return static_cast<double>(Number());
+    default: throw std::runtime_error("Cannot convert non-double JSON value to double");
+  }
+}
+
+inline bool JSONElement::AsBool() const
+{
+  if (IsNull()) return false;
+  if (!IsBool()) throw std::runtime_error("Cannot convert non-bool JSON value to bool");
+  return JSONTapeDetail::PayloadOf(Word()) != 0;
+}
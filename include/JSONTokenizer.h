@@ -0,0 +1,74 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSONDocument.h"
+#include "Token.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+struct JSONValue;
+class Lexer;
+
+/**
+ * @struct ParsedNumber
+ * @brief A number token converted to the narrowest type that holds it exactly.
+ *
+ * Integers become Int64, or UInt64 above INT64_MAX. Everything else, including integers
+ * too large for 64 bits, becomes a Double.
+ */
+struct ParsedNumber
+{
+  JSONType type;
+  union
+  {
+    int64_t integer;
+    uint64_t unsignedInteger;
+    double number;
+  };
+};
+
+/**
+ * @class JSONTokenizer
+ * @brief The token stream and token helpers that SAXParser and JSONBinder are built on.
+ *
+ * It wraps the library's Lexer, which is not part of the public headers. The lexer is kept
+ * inside the tokenizer rather than on the heap, so creating a tokenizer allocates nothing.
+ */
+class JSONTokenizer
+{
+public:
+  /// Throws std::runtime_error from NextToken() on a string that is not valid UTF-8, unless `validateUTF8` is false.
+  explicit JSONTokenizer(std::string_view source, bool validateUTF8 = true);
+  ~JSONTokenizer();
+
+  JSONTokenizer(const JSONTokenizer&) = delete;
+  JSONTokenizer& operator=(const JSONTokenizer&) = delete;
+
+  /// Lex and return the next token, END_OF_FILE once the source is exhausted.
+  Token NextToken();
+
+  /// Skip the value whose first token, `first`, was the last one returned.
+  void SkipValue(const Token& first);
+
+  /// Decode the escapes of a string token's value into `out`, which must have room for
+  /// `value.size()` characters. Returns the number of characters written.
+  static std::size_t Unescape(std::string_view value, char* out);
+
+  /// Convert an INT or DOUBLE token to the narrowest type that holds it exactly.
+  static ParsedNumber ParseNumber(const Token& token);
+
+  /// Parse the value at the start of `source`, ignoring anything after it.
+  static JSONValue ParsePrefix(std::string_view source, bool validateUTF8 = true);
+
+  /// The error a parse throws when the input nests deeper than `maxDepth`.
+  static std::runtime_error DepthError(std::size_t maxDepth);
+
+private:
+  alignas(8) std::byte m_storage[128];
+
+  Lexer& GetLexer();
+};
@@ -0,0 +1,107 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSON.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class JSONWriter
+ * @brief Serializes JSON values into a growable buffer, a file descriptor or an std::ostream.
+ *
+ * In buffer mode the output is appended to a string owned by the caller. Clearing and
+ * reusing that string keeps its capacity, so encoding a response allocates nothing once the
+ * buffer has grown to size. In descriptor and stream mode the output is staged in a chunk
+ * of fixed size that is written out whenever it fills up, so the whole document is never
+ * held in memory.
+ *
+ * Numbers are written with std::to_chars in their shortest round-trip form, and strings
+ * are escaped as RFC 8259 requires. NaN and infinity have no JSON form and are written as null.
+ * Values are written without recursion, so there is no limit to how deeply they may nest.
+ *
+ * @code
+ * std::string buffer;
+ * buffer.clear();
+ * JSONWriter(buffer).Write(response);
+ * @endcode
+ */
+class JSONWriter
+{
+public:
+  static constexpr std::size_t DefaultChunkSize = 64 * 1024;
+
+  /// Append to `buffer`, which grows as needed.
+  explicit JSONWriter(std::string& buffer);
+
+  /// Write to an open file descriptor in chunks of `chunkSize` bytes.
+  explicit JSONWriter(int descriptor, std::size_t chunkSize = DefaultChunkSize);
+
+  /// Write to `stream` in chunks of `chunkSize` bytes.
+  explicit JSONWriter(std::ostream& stream, std::size_t chunkSize = DefaultChunkSize);
+
+  /// Flushes whatever is still staged. Call Flush() first to see write errors.
+  ~JSONWriter();
+
+  JSONWriter(const JSONWriter&) = delete;
+  JSONWriter& operator=(const JSONWriter&) = delete;
+
+  void Write(const JSONValue& value);
+  void Write(const JSONNode& node);
+
+  // Single tokens, for writing JSON without building a tree first.
+  void WriteNull();
+  void WriteBool(bool value);
+  void WriteNumber(double value);
+  void WriteNumber(int64_t value);
+  void WriteNumber(uint64_t value);
+  void WriteString(std::string_view value);
+  void WriteRaw(std::string_view text);
+
+  /**
+   * @brief Writes out the staged chunk. Does nothing in buffer mode.
+   * @throws std::runtime_error If the descriptor or stream reports an error.
+   */
+  void Flush();
+
+private:
+  enum class Sink : uint8_t
+  {
+    Buffer,
+    Descriptor,
+    Stream
+  };
+
+  Sink m_sink;
+  std::string* m_out;  // The caller's buffer, or m_chunk
+  std::string m_chunk;
+  std::size_t m_chunkSize = 0;
+  std::size_t m_limit; // Size of m_out at which the chunk is flushed; never reached in buffer mode
+  int m_descriptor = -1;
+  std::ostream* m_stream = nullptr;
+
+  // An array or object that Write(const JSONValue&) has opened, and the index of its next child.
+  struct Frame
+  {
+    const JSONValue* container;
+    std::size_t next;
+  };
+  std::vector<Frame> m_stack;
+
+  // The same for Write(const JSONNode&).
+  struct NodeFrame
+  {
+    const JSONNode* container;
+    uint32_t next;
+  };
+  std::vector<NodeFrame> m_nodeStack;
+
+  void Append(const char* data, std::size_t length);
+  void Put(char c);
+  void WriteOut(const char* data, std::size_t length);
+};
@@ -40,11 +40,19 @@ enum class TokenType
  * @details
  * - The `type` field indicates the category of the token (e.g., braces, strings, numbers).
  * - The `value` field contains the textual representation of the token,
+ * - The `escaped` flag is set on STRING tokens whose value contains a backslash escape.
  */
 struct Token
 {
   TokenType type;
   std::string_view value;
+  bool escaped = false;
+
+  /// Where the token starts in the source, including the opening quote of strings.
+  [[nodiscard]] const char* Begin() const
+  {
+    return type == TokenType::STRING ? value.data() - 1 : value.data();
+  }
 
   /**
    * @brief Converts the TokenType of the token to its string representation.
@@ -4,6 +4,7 @@
 
 #include "JSON.h"
 #include <iostream>
+#include <map>
 
 int main()
 {
@@ -3,56 +3,173 @@
 //
 
 #include "JSON.h"
+#include "JSONWriter.h"
 
+#include <chrono>
 #include <filesystem>
 
 #include "Lexer.h"
+#include "MappedFile.h"
 #include "Parser.h"
 #include <fstream>
-#include <iostream>
-#include <sstream>
+#include <memory>
+
+namespace
+{
+  // Containers of this thread being destroyed or copied on the call stack, see JSONData.
+  thread_local std::size_t destroyDepth = 0;
+  thread_local std::size_t copyDepth = 0;
+
+  /// Counts one more level of recursion for as long as it lives, also when a copy throws.
+  class RecursionLevel
+  {
+  public:
+    explicit RecursionLevel(std::size_t& depth) : m_depth(depth) { m_depth++; }
+    ~RecursionLevel() { m_depth--; }
+
+    RecursionLevel(const RecursionLevel&) = delete;
+    RecursionLevel& operator=(const RecursionLevel&) = delete;
+
+  private:
+    std::size_t& m_depth;
+  };
+
+  bool HasChildren(const JSONValue& value)
+  {
+    if (const auto* array = std::get_if<std::vector<JSONValue>>(&value.data)) return !array->empty();
+    if (const auto* object = std::get_if<JSONObject>(&value.data)) return !object->empty();
+    return false;
+  }
+
+  /// Moves the children of an array or object that have children of their own to `pending`,
+  /// and destroys the others.
+  void MoveChildren(JSONData& data, std::vector<JSONValue>& pending)
+  {
+    if (auto* array = std::get_if<std::vector<JSONValue>>(&data))
+    {
+      for (JSONValue& element : *array)
+      {
+        if (HasChildren(element)) pending.push_back(std::move(element));
+      }
+      array->clear();
+    }
+    else if (auto* object = std::get_if<JSONObject>(&data))
+    {
+      for (auto& [key, member] : *object)
+      {
+        if (HasChildren(member)) pending.push_back(std::move(member));
+      }
+      object->clear();
+    }
+  }
+
+  /// An empty array or object, whichever `data` holds.
+  JSONData EmptyLike(const JSONData& data)
+  {
+    if (std::holds_alternative<JSONObject>(data)) return JSONData{JSONObject()};
+    return JSONData{std::vector<JSONValue>()};
+  }
+}
 
 /**
- * Converts the JSONValue instance into its string representation.
+ * Destroys the elements or members of an array or object.
  *
- * The output format depends on the type of the contained value:
- * - A numeric value is converted to its string equivalent.
- * - A boolean value is converted to "true" or "false".
- * - A string value is enclosed in double quotes.
- * - A JSON array is represented as a comma-separated list enclosed in square brackets.
- * - A JSON object is represented as a comma-separated list of key-value pairs enclosed in curly braces,
- *   where keys are strings enclosed in double quotes.
- *
- * @return A string representation of the JSONValue instance.
+ * Up to RecursionLimit levels deep, each child is destroyed in place and may recurse in turn.
+ * Deeper than that, the children that have children of their own are moved onto a stack on
+ * the heap and emptied one at a time, so each is a leaf by the time it is destroyed.
  */
-std::string JSONValue::ToString() const
+void JSONData::DestroyChildren() noexcept
 {
-  if (IsDouble()) return std::to_string(AsDouble());
+  if (destroyDepth < RecursionLimit)
+  {
+    const RecursionLevel level(destroyDepth);
+    if (auto* array = std::get_if<std::vector<JSONValue>>(this)) array->clear();
+    else std::get<JSONObject>(*this).clear();
+    return;
+  }
 
-  if (IsBool()) return AsBool() ? "true" : "false";
+  std::vector<JSONValue> pending;
+  MoveChildren(*this, pending);
+  while (!pending.empty())
+  {
+    JSONValue value = std::move(pending.back());
+    pending.pop_back();
+    MoveChildren(value.data, pending);
+  }
+}
 
-  if (IsString()) return "\"" + AsString() + "\"";
+/**
+ * Copies an array or object with everything inside it.
+ *
+ * Up to RecursionLimit levels deep, this is the variant's own copy, which copies every child
+ * through JSONData in turn. Deeper than that, the copy is built from the top down: each container
+ * is created empty with room for all of its children, and the containers among those children
+ * wait on a stack on the heap until their own children are copied in.
+ */
+JSONData::variant JSONData::CopyContainer(const JSONData& other)
+{
+  if (copyDepth < RecursionLimit)
+  {
+    const RecursionLevel level(copyDepth);
+    return static_cast<const variant&>(other);
+  }
 
-  if (IsJSONArray())
+  JSONData copy = EmptyLike(other);
+  std::vector<std::pair<const JSONData*, JSONData*>> pending{{&other, &copy}};
+  while (!pending.empty())
   {
-    std::string result = "[";
-    for (const auto& element : AsArray())
+    const auto [source, target] = pending.back();
+    pending.pop_back();
+
+    if (const auto* array = std::get_if<std::vector<JSONValue>>(source))
     {
-      result += element.ToString() + ", ";
+      auto& elements = std::get<std::vector<JSONValue>>(*target);
+      elements.reserve(array->size()); // Nothing moves once the children have been added
+      for (const JSONValue& element : *array)
+      {
+        if (!element.data.HasChildren()) elements.push_back(element);
+        else
+        {
+          elements.push_back(JSONValue{EmptyLike(element.data)});
+          pending.emplace_back(&element.data, &elements.back().data);
+        }
+      }
+      continue;
     }
-    return result.substr(0, result.size() - 2) + "]";
-  }
 
-  if (IsJSONObject())
-  {
-    std::string result = "{";
-    for (const auto& [key, value] : AsObject())
+    auto& members = std::get<JSONObject>(*target);
+    const auto& object = std::get<JSONObject>(*source);
+    members.reserve(object.size());
+    for (const auto& [key, member] : object)
     {
-      result += "\"" + key + "\": " + value.ToString() + ", ";
+      if (!member.data.HasChildren()) members.emplace(key, member);
+      else pending.emplace_back(&member.data, &members.emplace(key, JSONValue{EmptyLike(member.data)}).first->Value().data);
     }
-    return result.substr(0, result.size() - 2) + "}";
   }
-  return "";
+  return static_cast<variant&&>(copy);
+}
+
+/**
+ * Converts the JSONValue instance into its string representation.
+ *
+ * The output format depends on the type of the contained value:
+ * - A null value is converted to "null".
+ * - A numeric value is converted to its shortest round-trip string equivalent.
+ * - A boolean value is converted to "true" or "false".
+ * - A string value is escaped and enclosed in double quotes.
+ * - A JSON array is represented as a comma-separated list enclosed in square brackets.
+ * - A JSON object is represented as a comma-separated list of key-value pairs enclosed in curly braces,
+ *   where keys are strings enclosed in double quotes.
+ *
+ * To reuse a buffer, or to write straight to a file, use a JSONWriter instead.
+ *
+ * @return A string representation of the JSONValue instance.
+ */
+std::string JSONValue::ToString() const
+{
+  std::string result;
+  JSONWriter(result).Write(*this);
+  return result;
 }
 
 /**
@@ -64,31 +181,151 @@ std::string JSONValue::ToString() const
  */
 JSONValue JSON::Parse(const std::string& source)
 {
-  auto tokens = Lexer::Tokenize(source);
-  return Parser::Parse(tokens);
+  return Parser::Parse(std::string_view(source));
+}
+
+/**
+ * Parses a JSON string into a JSONValue and reports where the parse spent its time and memory.
+ *
+ * @param source The JSON-encoded string to parse.
+ * @param stats Reset, then filled in. See ParseStats.
+ * @return A JSONValue representing the parsed JSON data.
+ * @throws std::runtime_error If the input is not valid JSON.
+ */
+JSONValue JSON::Parse(const std::string& source, ParseStats& stats)
+{
+  return Parser::Parse(std::string_view(source), stats);
+}
+
+/**
+ * Parses a JSON string into a JSONValue with settings other than the defaults.
+ *
+ * @param source The JSON-encoded string to parse.
+ * @param options Settings for the parse. Only `options.maxDepth` and `options.validateUTF8` apply to a JSONValue.
+ * @return A JSONValue representing the parsed JSON data.
+ * @throws std::runtime_error If the input is not valid JSON or nests deeper than `options.maxDepth`.
+ */
+JSONValue JSON::Parse(const std::string& source, const ParseOptions& options)
+{
+  return Parser::Parse(std::string_view(source), options);
+}
+
+/**
+ * Parses a JSON string into an arena-backed, read-only JSONDocument.
+ *
+ * All nodes, keys and strings are copied into the document's arena, so the source
+ * does not need to outlive the result, unless `options.zeroCopyStrings` is set.
+ *
+ * @param source The JSON-encoded string to be parsed.
+ * @param options Settings for the parse.
+ * @return A JSONDocument holding the parsed JSON.
+ * @throws std::runtime_error If the input cannot be tokenized or parsed properly.
+ */
+JSONDocument JSON::ParseDocument(const std::string_view source, const ParseOptions& options)
+{
+  JSONDocument document;
+  Parser::Parse(source, document, options);
+  return document;
+}
+
+/**
+ * Parses a JSON string into a JSONTape, a single contiguous array of words in document order.
+ *
+ * @param source The JSON-encoded string to parse.
+ * @param options Settings for the parse. Only `options.maxDepth` and `options.validateUTF8` apply to a tape.
+ * @return The tape, which does not refer to the source.
+ * @throws std::runtime_error If the input is not valid JSON.
+ */
+JSONTape JSON::ParseTape(const std::string_view source, const ParseOptions& options)
+{
+  JSONTape tape;
+  Parser::Parse(source, tape, options);
+  return tape;
+}
+
+/**
+ * Returns an on-demand cursor to the root of a JSON string without parsing it.
+ *
+ * Values are only lexed when they are looked up, and containers that are passed over
+ * are skipped. The source must outlive the cursor and every cursor derived from it.
+ *
+ * @param source The JSON-encoded string to navigate.
+ * @param options Settings for the lexing. Only `options.validateUTF8` applies.
+ * @return A JSONCursor to the root value.
+ */
+JSONCursor JSON::ParseOnDemand(const std::string_view source, const ParseOptions& options)
+{
+  return JSONCursor(source, options.validateUTF8);
 }
 
 /**
  * Loads and parses a JSON file from the specified file path.
  *
  * @param filepath The path to the JSON file to be loaded.
+ * The file is memory-mapped where possible and parsed in place, so no copy of its
+ * contents is made.
+ *
  * @return A JSONValue object representing the parsed JSON content.
  * @throws std::runtime_error If the file could not be opened or its contents could not be parsed.
  */
 JSONValue JSON::LoadFromFile(const std::string& filepath)
 {
-  std::ifstream file(filepath);
-  if (!file.is_open())
-  {
-    throw std::runtime_error("Could not open file");
-  }
+  const MappedFile file(filepath);
+  return Parser::Parse(file.View());
+}
 
-  std::stringstream buffer;
-  buffer << file.rdbuf();
+/**
+ * Loads and parses a JSON file, reporting where the time and memory went, including the
+ * time spent opening and mapping the file.
+ *
+ * @param filepath The path to the JSON file to be loaded.
+ * @param stats Reset, then filled in. See ParseStats.
+ * @return A JSONValue object representing the parsed JSON content.
+ * @throws std::runtime_error If the file could not be opened or its contents could not be parsed.
+ */
+JSONValue JSON::LoadFromFile(const std::string& filepath, ParseStats& stats)
+{
+  const auto start = std::chrono::steady_clock::now();
+  const MappedFile file(filepath);
+  const auto read = static_cast<uint64_t>(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
 
-  return Parse(buffer.str());
+  JSONValue value = Parser::Parse(file.View(), stats);
+  stats.readNanoseconds = read;
+  stats.totalNanoseconds += read;
+  return value;
 }
 
+/**
+ * Loads a JSON file into an arena-backed JSONDocument.
+ *
+ * The file is memory-mapped where possible and parsed in place. With
+ * `options.zeroCopyStrings`, unescaped strings point straight into the mapping,
+ * which the document then keeps alive for as long as it exists.
+ *
+ * @param filepath The path to the JSON file to be loaded.
+ * @param options Settings for the parse.
+ * @return A JSONDocument holding the parsed JSON.
+ * @throws std::runtime_error If the file could not be opened or its contents could not be parsed.
+ */
+JSONDocument JSON::LoadDocumentFromFile(const std::string& filepath, const ParseOptions& options)
+{
+  auto file = std::make_shared<const MappedFile>(filepath);
+
+  JSONDocument document;
+  Parser::Parse(file->View(), document, options);
+  if (options.zeroCopyStrings) document.m_source = std::move(file);
+  return document;
+}
+
+/**
+ * Writes a JSONValue to a file, creating missing parent directories.
+ *
+ * The value is serialized in fixed-size chunks, so the whole output is never held in memory.
+ *
+ * @param filepath The path of the file to write.
+ * @param value The value to serialize.
+ * @throws std::runtime_error If the file cannot be opened or written.
+ */
 void JSON::SaveToFile(const std::string& filepath, const JSONValue& value)
 {
   // Make sure the path exist
@@ -100,15 +337,50 @@ void JSON::SaveToFile(const std::string& filepath, const JSONValue& value)
     std::filesystem::create_directories(dir);
   }
 
-  const std::string json = value.ToString();
+  std::ofstream file(filepath, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file.is_open()) throw std::runtime_error("Could not open file: " + filepath);
 
-  std::ofstream file(filepath, std::ios::out | std::ios::trunc);
+  JSONWriter writer(file);
+  writer.Write(value);
+  writer.Flush();
+  file.close();
+  if (!file) throw std::runtime_error("Could not write file: " + filepath);
+}
 
-  if (!file.is_open())
-  {
-    std::cerr << "Could not open file: " + filepath << std::endl;
-  }
+/**
+ * Writes a JSONValue to a file as a binary snapshot, creating missing parent directories.
+ *
+ * @param filepath The path of the file to write.
+ * @param value The value to encode.
+ * @throws std::runtime_error If the file cannot be opened or written.
+ */
+void JSON::SaveBinary(const std::string& filepath, const JSONValue& value)
+{
+  const std::filesystem::path path(filepath);
+  if (!path.parent_path().empty()) std::filesystem::create_directories(path.parent_path());
 
-  file << json;
-  file.close();
+  const std::string snapshot = JSONSnapshot::Encode(value);
+  std::ofstream file(filepath, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file.is_open()) throw std::runtime_error("Could not open file: " + filepath);
+
+  file.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()));
+  if (!file) throw std::runtime_error("Could not write file: " + filepath);
+}
+
+/**
+ * Opens a binary snapshot written by JSON::SaveBinary.
+ *
+ * The file is memory-mapped and only its header is checked, so this takes the same time
+ * for any size of document. Values are read from the mapping as they are navigated, and
+ * the mapping stays alive as long as the snapshot or a copy of it does.
+ *
+ * @param filepath The path of the snapshot.
+ * @return A JSONSnapshot whose Root() is the saved value.
+ * @throws std::runtime_error If the file cannot be opened or is not a valid snapshot.
+ */
+JSONSnapshot JSON::LoadBinary(const std::string& filepath)
+{
+  auto file = std::make_shared<const MappedFile>(filepath, MappedFile::Access::Random);
+  const std::string_view bytes = file->View();
+  return JSONSnapshot::View(bytes, std::move(file));
 }
@@ -0,0 +1,203 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONCursor.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <stdexcept>
+
+JSONCursor::JSONCursor(const std::string_view source, const bool validateUTF8)
+  : m_validateUTF8(validateUTF8)
+{
+  Lexer lexer(source, validateUTF8);
+  const Token first = lexer.NextToken();
+  if (first.type != TokenType::END_OF_FILE) m_text = source.substr(first.Begin() - source.data());
+}
+
+/**
+ * A missing value reads as null. Otherwise a value that starts like `null` must be exactly
+ * that literal, as when it is parsed.
+ */
+bool JSONCursor::IsNull() const
+{
+  if (!Exists()) return true;
+  if (m_text.front() != 'n') return false;
+  CheckLiteral("null");
+  return true;
+}
+
+bool JSONCursor::IsBool() const
+{
+  if (!Exists()) return false;
+  if (m_text.front() == 't') CheckLiteral("true");
+  else if (m_text.front() == 'f') CheckLiteral("false");
+  else return false;
+  return true;
+}
+
+/**
+ * Lexes the value's first token, and throws the parser's error unless it is `literal`.
+ * Only the first character has been looked at before, so this is what rejects e.g. `txyz`.
+ */
+void JSONCursor::CheckLiteral(const std::string_view literal) const
+{
+  Lexer lexer(m_text, m_validateUTF8);
+  const Token token = lexer.NextToken();
+  if (token.value != literal) throw std::runtime_error("Unexpected token type" + std::string(token.value));
+}
+
+JSONCursor JSONCursor::operator[](const int index) const
+{
+  if (!IsJSONArray()) throw std::runtime_error("Cannot access element of non-array JSON value");
+  if (index < 0) return {};
+
+  Lexer lexer(m_text, m_validateUTF8);
+  lexer.NextToken(); // Eat beginning bracket
+
+  Token token = lexer.NextToken();
+  if (token.type == TokenType::RIGHT_BRACKET) return {};
+
+  for (int i = 0; ; i++)
+  {
+    if (i == index)
+    {
+      JSONCursor element;
+      element.m_text = m_text.substr(token.Begin() - m_text.data());
+      element.m_validateUTF8 = m_validateUTF8;
+      return element;
+    }
+
+    lexer.SkipValue(token);
+    if (!lexer.NextSeparator(TokenType::RIGHT_BRACKET)) return {};
+    token = lexer.NextToken();
+  }
+}
+
+/**
+ * Looks a member up by key. A key that occurs more than once yields its last value, as in a
+ * JSONValue, so the search always skips to the end of the object.
+ */
+JSONCursor JSONCursor::operator[](const std::string_view key) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+
+  Lexer lexer(m_text, m_validateUTF8);
+  lexer.NextToken(); // Eat beginning brace
+
+  Token token = lexer.NextToken();
+  if (token.type == TokenType::RIGHT_BRACE) return {};
+
+  JSONCursor found;
+  std::string unescaped;
+  while (true)
+  {
+    if (token.type != TokenType::STRING) throw std::runtime_error("Unexpected token type");
+
+    bool match = token.value == key;
+    if (token.escaped)
+    {
+      unescaped.resize(token.value.size());
+      unescaped.resize(Parser::Unescape(token.value, unescaped.data()));
+      match = unescaped == key;
+    }
+
+    if (lexer.NextToken().type != TokenType::COLON) throw std::runtime_error("Unexpected token type");
+
+    const Token value = lexer.NextToken();
+    if (match)
+    {
+      found.m_text = m_text.substr(value.Begin() - m_text.data());
+      found.m_validateUTF8 = m_validateUTF8;
+    }
+
+    lexer.SkipValue(value);
+    if (!lexer.NextSeparator(TokenType::RIGHT_BRACE)) return found;
+    token = lexer.NextToken();
+  }
+}
+
+std::size_t JSONCursor::Size() const
+{
+  if (!IsJSONArray() && !IsJSONObject()) throw std::runtime_error("Cannot take the size of a non-container JSON value");
+  const TokenType closing = IsJSONArray() ? TokenType::RIGHT_BRACKET : TokenType::RIGHT_BRACE;
+
+  Lexer lexer(m_text, m_validateUTF8);
+  lexer.NextToken(); // Eat the opening token
+
+  Token token = lexer.NextToken();
+  if (token.type == closing) return 0;
+
+  std::size_t size = 0;
+  while (true)
+  {
+    if (closing == TokenType::RIGHT_BRACE)
+    {
+      if (lexer.NextToken().type != TokenType::COLON) throw std::runtime_error("Unexpected token type");
+      token = lexer.NextToken();
+    }
+
+    lexer.SkipValue(token);
+    size++;
+    if (!lexer.NextSeparator(closing)) return size;
+    token = lexer.NextToken();
+  }
+}
+
+std::string JSONCursor::AsString() const
+{
+  if (!Exists()) return "";
+  if (!IsString()) throw std::runtime_error("Cannot convert non-string JSON value to string");
+
+  Lexer lexer(m_text, m_validateUTF8);
+  const Token token = lexer.NextToken();
+  if (!token.escaped) return std::string(token.value);
+
+  std::string value;
+  value.resize(token.value.size());
+  value.resize(Parser::Unescape(token.value, value.data()));
+  return value;
+}
+
+double JSONCursor::AsDouble() const
+{
+  if (IsNull()) return 0.0;
+  if (!IsDouble()) throw std::runtime_error("Cannot convert non-double JSON value to double");
+
+  Lexer lexer(m_text, m_validateUTF8);
+  return Parser::ParseNumberValue(lexer.NextToken()).AsDouble();
+}
+
+int64_t JSONCursor::AsInt64() const
+{
+  if (IsNull()) return 0;
+  if (!IsDouble()) throw std::runtime_error("Cannot convert non-number JSON value to int64_t");
+
+  Lexer lexer(m_text, m_validateUTF8);
+  return Parser::ParseNumberValue(lexer.NextToken()).AsInt64();
+}
+
+uint64_t JSONCursor::AsUInt64() const
+{
+  if (IsNull()) return 0;
+  if (!IsDouble()) throw std::runtime_error("Cannot convert non-number JSON value to uint64_t");
+
+  Lexer lexer(m_text, m_validateUTF8);
+  return Parser::ParseNumberValue(lexer.NextToken()).AsUInt64();
+}
+
+bool JSONCursor::AsBool() const
+{
+  if (IsNull()) return false;
+  if (!IsBool()) throw std::runtime_error("Cannot convert non-bool JSON value to bool");
+  return m_text.front() == 't';
+}
+
+JSONValue JSONCursor::ToJSONValue() const
+{
+  if (!Exists()) return {};
+
+  ParseOptions options;
+  options.validateUTF8 = m_validateUTF8;
+  return Parser::ParsePrefix(m_text, options);
+}
@@ -0,0 +1,313 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONDocument.h"
+#include "JSON.h"
+#include "ValueBuilder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+
+Arena::~Arena()
+{
+  Release();
+}
+
+Arena::Arena(Arena&& other) noexcept
+  : m_chunks(std::exchange(other.m_chunks, nullptr)),
+    m_cursor(std::exchange(other.m_cursor, nullptr)),
+    m_end(std::exchange(other.m_end, nullptr)),
+    m_nextChunkSize(other.m_nextChunkSize),
+    m_allocations(std::exchange(other.m_allocations, 0)),
+    m_bytesAllocated(std::exchange(other.m_bytesAllocated, 0)),
+    m_bytesUsed(std::exchange(other.m_bytesUsed, 0))
+{
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept
+{
+  if (this != &other)
+  {
+    Release();
+    m_chunks = std::exchange(other.m_chunks, nullptr);
+    m_cursor = std::exchange(other.m_cursor, nullptr);
+    m_end = std::exchange(other.m_end, nullptr);
+    m_nextChunkSize = other.m_nextChunkSize;
+    m_allocations = std::exchange(other.m_allocations, 0);
+    m_bytesAllocated = std::exchange(other.m_bytesAllocated, 0);
+    m_bytesUsed = std::exchange(other.m_bytesUsed, 0);
+  }
+  return *this;
+}
+
+void Arena::Reserve(const std::size_t bytes)
+{
+  if (static_cast<std::size_t>(m_end - m_cursor) >= bytes) return;
+  if (bytes > m_nextChunkSize) m_nextChunkSize = bytes;
+}
+
+/**
+ * Bumps the cursor of the current chunk, starting a new chunk when it is full.
+ */
+void* Arena::Allocate(const std::size_t bytes, const std::size_t alignment)
+{
+  auto address = reinterpret_cast<std::uintptr_t>(m_cursor);
+  std::uintptr_t aligned = (address + alignment - 1) & ~(alignment - 1);
+
+  if (m_cursor == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(m_end))
+  {
+    AddChunk(bytes + alignment);
+    address = reinterpret_cast<std::uintptr_t>(m_cursor);
+    aligned = (address + alignment - 1) & ~(alignment - 1);
+  }
+
+  m_cursor = reinterpret_cast<char*>(aligned + bytes);
+  m_bytesUsed += bytes;
+  return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ * Requests a new chunk from the heap. Chunks grow geometrically, so the number of
+ * chunks stays small however large the document gets.
+ */
+void Arena::AddChunk(const std::size_t minimumBytes)
+{
+  std::size_t capacity = m_nextChunkSize;
+  if (capacity < minimumBytes) capacity = minimumBytes;
+
+  void* memory = std::malloc(sizeof(Chunk) + capacity);
+  if (memory == nullptr) throw std::bad_alloc();
+
+  auto* chunk = static_cast<Chunk*>(memory);
+  chunk->next = m_chunks;
+  chunk->capacity = capacity;
+  m_chunks = chunk;
+
+  m_cursor = reinterpret_cast<char*>(chunk + 1);
+  m_end = m_cursor + capacity;
+  m_nextChunkSize = capacity * 2;
+  m_allocations++;
+  m_bytesAllocated += sizeof(Chunk) + capacity;
+}
+
+void Arena::Reset()
+{
+  Chunk* largest = m_chunks;
+  for (Chunk* chunk = m_chunks; chunk != nullptr; chunk = chunk->next)
+  {
+    if (chunk->capacity > largest->capacity) largest = chunk;
+  }
+
+  while (m_chunks != nullptr)
+  {
+    Chunk* next = m_chunks->next;
+    if (m_chunks != largest) std::free(m_chunks);
+    m_chunks = next;
+  }
+
+  m_bytesUsed = 0;
+  m_bytesAllocated = 0;
+  m_cursor = nullptr;
+  m_end = nullptr;
+  if (largest == nullptr) return;
+
+  largest->next = nullptr;
+  m_chunks = largest;
+  m_cursor = reinterpret_cast<char*>(largest + 1);
+  m_end = m_cursor + largest->capacity;
+  m_bytesAllocated = sizeof(Chunk) + largest->capacity;
+}
+
+void Arena::Release()
+{
+  while (m_chunks != nullptr)
+  {
+    Chunk* next = m_chunks->next;
+    std::free(m_chunks);
+    m_chunks = next;
+  }
+  m_cursor = nullptr;
+  m_end = nullptr;
+}
+
+/**
+ * Returns the stored copy of `key`, copying it into the table's arena the first time it is seen.
+ */
+JSONKey KeyTable::Intern(const std::string_view key)
+{
+  // Keep the load factor at or below one half.
+  if ((m_count + 1) * 2 > m_slots.size())
+  {
+    std::vector<std::string_view> slots(m_slots.empty() ? 64 : m_slots.size() * 2);
+    const std::size_t mask = slots.size() - 1;
+    for (const std::string_view stored : m_slots)
+    {
+      if (stored.data() == nullptr) continue;
+      std::size_t slot = std::hash<std::string_view>{}(stored) & mask;
+      while (slots[slot].data() != nullptr) slot = (slot + 1) & mask;
+      slots[slot] = stored;
+    }
+    m_slots = std::move(slots);
+    m_rehashes++;
+  }
+
+  const std::size_t mask = m_slots.size() - 1;
+  std::size_t slot = std::hash<std::string_view>{}(key) & mask;
+  for (; m_slots[slot].data() != nullptr; slot = (slot + 1) & mask)
+  {
+    if (m_slots[slot] == key) return JSONKey{m_slots[slot]};
+  }
+
+  // Allocate at least one byte, so even the empty key has a unique address.
+  char* copy = m_arena.Allocate<char>(key.size() + 1);
+  std::memcpy(copy, key.data(), key.size());
+  m_slots[slot] = std::string_view(copy, key.size());
+  m_count++;
+  return JSONKey{m_slots[slot]};
+}
+
+void KeyTable::Clear()
+{
+  std::fill(m_slots.begin(), m_slots.end(), std::string_view());
+  m_count = 0;
+  m_arena.Reset();
+}
+
+JSONKey KeyTable::Find(const std::string_view key) const
+{
+  if (m_slots.empty()) return {};
+
+  const std::size_t mask = m_slots.size() - 1;
+  for (std::size_t slot = std::hash<std::string_view>{}(key) & mask; m_slots[slot].data() != nullptr; slot = (slot + 1) & mask)
+  {
+    if (m_slots[slot] == key) return JSONKey{m_slots[slot]};
+  }
+  return {};
+}
+
+void JSONDocument::Reset()
+{
+  m_arena.Reset();
+  m_keys.Clear();
+  m_sharedKeys = nullptr;
+  m_root = JSONNode();
+  m_source.reset();
+}
+
+const JSONNode& JSONNode::operator[](const int index) const
+{
+  if (!IsJSONArray()) throw std::runtime_error("Cannot access element of non-array JSON value");
+  if (index < 0 || static_cast<uint32_t>(index) >= size) return nullNode;
+  return elements[index];
+}
+
+/**
+ * Looks a member up by key. Members are stored in document order and searched linearly from
+ * the end, so a key that occurs more than once yields its last value, as in a JSONValue.
+ */
+const JSONNode& JSONNode::operator[](const std::string_view key) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  for (uint32_t i = size; i-- > 0;)
+  {
+    if (members[i].key == key) return members[i].value;
+  }
+  return nullNode;
+}
+
+const JSONNode& JSONNode::operator[](const JSONKey& key) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  for (uint32_t i = size; i-- > 0;)
+  {
+    if (members[i].key.data() == key.name.data()) return members[i].value;
+  }
+  return nullNode;
+}
+
+std::span<const JSONNode> JSONNode::Elements() const
+{
+  if (!IsJSONArray()) throw std::runtime_error("Cannot access element of non-array JSON value");
+  return {elements, size};
+}
+
+std::span<const JSONMember> JSONNode::Members() const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  return {members, size};
+}
+
+int64_t JSONNode::AsInt64() const
+{
+  switch (type)
+  {
+    case JSONType::Null:   return 0;
+    case JSONType::Int64:  return integer;
+    case JSONType::Double: return static_cast<int64_t>(number);
+    case JSONType::UInt64:
+      if (unsignedInteger > static_cast<uint64_t>(INT64_MAX)) throw std::runtime_error("JSON integer does not fit in int64_t");
+      return static_cast<int64_t>(unsignedInteger);
+    default: throw std::runtime_error("Cannot convert non-number JSON value to int64_t");
+  }
+}
+
+uint64_t JSONNode::AsUInt64() const
+{
+  switch (type)
+  {
+    case JSONType::Null:   return 0;
+    case JSONType::UInt64: return unsignedInteger;
+    case JSONType::Double: return static_cast<uint64_t>(number);
+    case JSONType::Int64:
+      if (integer < 0) throw std::runtime_error("Negative JSON integer does not fit in uint64_t");
+      return static_cast<uint64_t>(integer);
+    default: throw std::runtime_error("Cannot convert non-number JSON value to uint64_t");
+  }
+}
+
+JSONValue JSONNode::ToJSONValue() const
+{
+  const auto shallow = [](const JSONNode& node) -> JSONValue
+  {
+    switch (node.type)
+    {
+      case JSONType::Double: return JSONValue{node.number};
+      case JSONType::Int64:  return JSONValue{node.integer};
+      case JSONType::UInt64: return JSONValue{node.unsignedInteger};
+      case JSONType::Bool:   return JSONValue{node.boolean};
+      case JSONType::String: return JSONValue{std::string(node.string, node.size)};
+
+      case JSONType::Array:
+      {
+        std::vector<JSONValue> array;
+        array.reserve(node.size);
+        return JSONValue{std::move(array)};
+      }
+
+      case JSONType::Object:
+      {
+        JSONObject object;
+        object.reserve(node.size);
+        return JSONValue{std::move(object)};
+      }
+
+      default: return {};
+    }
+  };
+
+  return BuildJSONValue(*this, shallow, [](const JSONNode& node, const auto& add)
+  {
+    if (node.type == JSONType::Array)
+    {
+      for (const JSONNode& element : node.Elements()) add({}, element);
+    }
+    else
+    {
+      for (const auto& [key, value] : node.Members()) add(key, value);
+    }
+  });
+}
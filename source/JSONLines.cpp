@@ -0,0 +1,172 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSON.h"
+#include "MappedFile.h"
+#include "Parser.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+  // Chunks are made at least this large, so each task amortises its scheduling cost.
+  constexpr std::size_t MinimumChunkSize = 256 * 1024;
+
+  // Each thread gets several chunks, so uneven lines still balance out.
+  constexpr std::size_t ChunksPerThread = 8;
+
+  struct Chunk
+  {
+    std::string_view text;
+    std::size_t firstLine; // 1-based number of the chunk's first line
+    std::vector<JSONValue> records;
+  };
+
+  /**
+   * Splits the source into chunks that start and end on line boundaries.
+   */
+  std::vector<Chunk> SplitLines(const std::string_view source, const unsigned int threads)
+  {
+    std::size_t target = source.size() / (static_cast<std::size_t>(threads) * ChunksPerThread);
+    if (target < MinimumChunkSize) target = MinimumChunkSize;
+
+    std::vector<Chunk> chunks;
+    std::size_t start = 0;
+    while (start < source.size())
+    {
+      std::size_t end = start + target;
+      if (end >= source.size()) end = source.size();
+      else
+      {
+        end = source.find('\n', end);
+        end = end == std::string_view::npos ? source.size() : end + 1;
+      }
+
+      chunks.push_back(Chunk{source.substr(start, end - start), 0, {}});
+      start = end;
+    }
+    return chunks;
+  }
+
+  bool IsBlank(const std::string_view line)
+  {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+  }
+
+  /**
+   * Parses every non-blank line of a chunk. Errors are reported with their line number.
+   */
+  void ParseChunk(Chunk& chunk, const ParseOptions& options)
+  {
+    std::size_t lineNumber = chunk.firstLine;
+    std::size_t start = 0;
+    while (start < chunk.text.size())
+    {
+      std::size_t end = chunk.text.find('\n', start);
+      if (end == std::string_view::npos) end = chunk.text.size();
+
+      const std::string_view line = chunk.text.substr(start, end - start);
+      if (!IsBlank(line))
+      {
+        try
+        {
+          chunk.records.push_back(Parser::Parse(line, options));
+        }
+        catch (const std::exception& e)
+        {
+          throw std::runtime_error("Line " + std::to_string(lineNumber) + ": " + e.what());
+        }
+      }
+
+      lineNumber++;
+      start = end + 1;
+    }
+  }
+
+  /**
+   * Numbers the first line of every chunk. Counting newlines is much cheaper than
+   * parsing, so it is done up front on the calling thread.
+   */
+  void NumberLines(std::vector<Chunk>& chunks)
+  {
+    std::size_t line = 1;
+    for (Chunk& chunk : chunks)
+    {
+      chunk.firstLine = line;
+      for (const char c : chunk.text) line += c == '\n';
+    }
+  }
+}
+
+/**
+ * Parses newline-delimited JSON (JSON Lines) on several threads.
+ *
+ * The source is split into newline-aligned chunks that are parsed concurrently. Blank
+ * lines are skipped. The records are returned in the order they appear in the source.
+ *
+ * @param source One JSON value per line.
+ * @param threads Number of threads to use, or 0 for one per hardware thread.
+ * @param options Settings for every line. Only `options.maxDepth` and `options.validateUTF8` apply.
+ * @return The parsed records in source order.
+ * @throws std::runtime_error If a line is not valid JSON. The message names the first failing line.
+ */
+std::vector<JSONValue> JSON::ParseLines(const std::string_view source, const unsigned int threads, const ParseOptions& options)
+{
+  std::vector<JSONValue> records;
+  ParseLines(source, [&records](JSONValue&& record) { records.push_back(std::move(record)); }, threads, options);
+  return records;
+}
+
+/**
+ * Parses newline-delimited JSON on several threads and hands each record to `callback`.
+ *
+ * The callback is always called on the calling thread, in source order. Chunks are parsed
+ * in batches of a few per thread, so only a bounded number of records is held at once.
+ *
+ * @param source One JSON value per line.
+ * @param callback Receives every record in source order.
+ * @param threads Number of threads to use, or 0 for one per hardware thread.
+ * @param options Settings for every line. Only `options.maxDepth` and `options.validateUTF8` apply.
+ * @throws std::runtime_error If a line is not valid JSON. Records before the failing batch have been delivered.
+ */
+void JSON::ParseLines(const std::string_view source, const std::function<void(JSONValue&&)>& callback,
+                      unsigned int threads, const ParseOptions& options)
+{
+  threads = ThreadPool::Resolve(threads);
+  std::vector<Chunk> chunks = SplitLines(source, threads);
+  NumberLines(chunks);
+
+  // One pool serves every batch, so the threads are started once per call.
+  const std::size_t batchSize = static_cast<std::size_t>(threads) * 2;
+  ThreadPool pool(static_cast<unsigned int>(std::min<std::size_t>(threads, chunks.size())));
+  for (std::size_t batch = 0; batch < chunks.size(); batch += batchSize)
+  {
+    const std::size_t count = std::min(batchSize, chunks.size() - batch);
+    pool.ParallelFor(count, [&chunks, batch, &options](const std::size_t i) { ParseChunk(chunks[batch + i], options); });
+
+    for (std::size_t i = batch; i < batch + count; i++)
+    {
+      for (JSONValue& record : chunks[i].records) callback(std::move(record));
+      chunks[i].records = {};
+    }
+  }
+}
+
+/**
+ * Loads a JSON Lines file and parses it on several threads.
+ *
+ * The file is memory-mapped where possible, so the lines are parsed in place.
+ *
+ * @param filepath The path to the file.
+ * @param threads Number of threads to use, or 0 for one per hardware thread.
+ * @param options Settings for every line. Only `options.maxDepth` and `options.validateUTF8` apply.
+ * @return The parsed records in file order.
+ * @throws std::runtime_error If the file could not be opened or a line is not valid JSON.
+ */
+std::vector<JSONValue> JSON::LoadLinesFromFile(const std::string& filepath, const unsigned int threads, const ParseOptions& options)
+{
+  const MappedFile file(filepath);
+  return ParseLines(file.View(), threads, options);
+}
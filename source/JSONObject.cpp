@@ -0,0 +1,178 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSON.h"
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+// Growing the member vector moves the members rather than copying them only if moving cannot throw.
+static_assert(std::is_nothrow_move_constructible_v<JSONObject::value_type>);
+
+// Comparing sizes first rejects most mismatches without touching the characters.
+static bool KeyEquals(const std::string& key, const std::string_view other)
+{
+  return key.size() == other.size() && std::memcmp(key.data(), other.data(), other.size()) == 0;
+}
+
+JSONObject::JSONObject() = default;
+JSONObject::JSONObject(const JSONObject& other) = default;
+JSONObject::JSONObject(JSONObject&& other) noexcept = default;
+JSONObject& JSONObject::operator=(const JSONObject& other) = default;
+JSONObject& JSONObject::operator=(JSONObject&& other) noexcept = default;
+JSONObject::~JSONObject() = default;
+
+JSONObject::iterator JSONObject::begin() { return m_members.begin(); }
+JSONObject::iterator JSONObject::end() { return m_members.end(); }
+JSONObject::const_iterator JSONObject::begin() const { return m_members.begin(); }
+JSONObject::const_iterator JSONObject::end() const { return m_members.end(); }
+
+void JSONObject::clear()
+{
+  m_members.clear();
+  m_index.clear();
+}
+
+JSONObject::iterator JSONObject::find(const std::string_view key)
+{
+  const uint32_t member = Find(key);
+  return member == NotFound ? end() : begin() + member;
+}
+
+JSONObject::const_iterator JSONObject::find(const std::string_view key) const
+{
+  const uint32_t member = Find(key);
+  return member == NotFound ? end() : begin() + member;
+}
+
+JSONValue& JSONObject::at(const std::string_view key)
+{
+  const uint32_t member = Find(key);
+  if (member == NotFound) throw std::out_of_range("JSONObject::at: key not found");
+  return m_members[member].Value();
+}
+
+const JSONValue& JSONObject::at(const std::string_view key) const
+{
+  const uint32_t member = Find(key);
+  if (member == NotFound) throw std::out_of_range("JSONObject::at: key not found");
+  return m_members[member].Value();
+}
+
+JSONValue& JSONObject::operator[](const std::string_view key)
+{
+  const uint32_t member = Find(key);
+  if (member != NotFound) return m_members[member].Value();
+  return Append(std::string(key));
+}
+
+JSONValue& JSONObject::operator[](std::string&& key)
+{
+  const uint32_t member = Find(key);
+  if (member != NotFound) return m_members[member].Value();
+  return Append(std::move(key));
+}
+
+std::pair<JSONObject::iterator, bool> JSONObject::emplace(std::string key, JSONValue value)
+{
+  const uint32_t member = Find(key);
+  if (member != NotFound) return {begin() + member, false};
+
+  Append(std::move(key)) = std::move(value);
+  return {end() - 1, true};
+}
+
+/**
+ * Erasing shifts the following members down, so the index is rebuilt afterwards.
+ */
+std::size_t JSONObject::erase(const std::string_view key)
+{
+  const uint32_t member = Find(key);
+  if (member == NotFound) return 0;
+
+  m_members.erase(m_members.begin() + member);
+
+  m_index.clear();
+  if (m_members.size() > IndexThreshold) Rehash(m_members.size() * 2);
+  return 1;
+}
+
+JSONObject::const_iterator JSONObject::find(const std::string_view key, const std::size_t hash) const
+{
+  const uint32_t member = m_index.empty() ? Scan(key) : Probe(key, hash);
+  return member == NotFound ? end() : begin() + member;
+}
+
+std::size_t JSONObject::Hash(const std::string_view key)
+{
+  return std::hash<std::string_view>{}(key);
+}
+
+/**
+ * Returns the position of `key`, or NotFound. Small objects are scanned linearly,
+ * larger ones probe the hash index.
+ */
+uint32_t JSONObject::Find(const std::string_view key) const
+{
+  return m_index.empty() ? Scan(key) : Probe(key, Hash(key));
+}
+
+uint32_t JSONObject::Scan(const std::string_view key) const
+{
+  for (uint32_t i = 0; i < m_members.size(); i++)
+  {
+    if (KeyEquals(m_members[i].Key(), key)) return i;
+  }
+  return NotFound;
+}
+
+uint32_t JSONObject::Probe(const std::string_view key, const std::size_t hash) const
+{
+  const std::size_t mask = m_index.size() - 1;
+  for (std::size_t slot = hash & mask; m_index[slot] != 0; slot = (slot + 1) & mask)
+  {
+    const uint32_t member = m_index[slot] - 1;
+    if (KeyEquals(m_members[member].Key(), key)) return member;
+  }
+  return NotFound;
+}
+
+/**
+ * Appends a null member without checking for duplicates, and keeps the index up to date.
+ */
+JSONValue& JSONObject::Append(std::string&& key)
+{
+  m_members.emplace_back(std::move(key));
+  const auto member = static_cast<uint32_t>(m_members.size() - 1);
+
+  if (!m_index.empty())
+  {
+    // Keep the load factor at or below one half.
+    if (m_members.size() * 2 > m_index.size()) Rehash(m_index.size() * 2);
+    else Insert(member);
+  }
+  else if (m_members.size() > IndexThreshold)
+  {
+    Rehash(IndexThreshold * 4);
+  }
+
+  return m_members.back().Value();
+}
+
+void JSONObject::Insert(const uint32_t member)
+{
+  const std::size_t mask = m_index.size() - 1;
+  std::size_t slot = Hash(m_members[member].Key()) & mask;
+  while (m_index[slot] != 0) slot = (slot + 1) & mask;
+  m_index[slot] = member + 1;
+}
+
+void JSONObject::Rehash(const std::size_t slots)
+{
+  std::size_t size = 1;
+  while (size < slots) size *= 2;
+
+  m_index.assign(size, 0);
+  for (uint32_t i = 0; i < m_members.size(); i++) Insert(i);
+}
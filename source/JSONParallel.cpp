@@ -0,0 +1,102 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSON.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+  // Elements are grouped into tasks of at least this many bytes.
+  constexpr std::size_t MinimumTaskSize = 64 * 1024;
+
+  bool IsBlank(const std::string_view text)
+  {
+    return text.find_first_not_of(" \t\n\r") == std::string_view::npos;
+  }
+}
+
+/**
+ * Parses a document whose root is a large array, parsing its elements on several threads.
+ *
+ * A single sequential pass over the structural bitmaps finds the commas that separate the
+ * top-level elements, skipping anything inside strings. The elements are then parsed
+ * concurrently, in groups of roughly equal size, directly into their slot of the result
+ * array, so the original order is kept. Any other document is parsed on the calling thread.
+ *
+ * @param source The JSON-encoded text to parse.
+ * @param threads Number of threads to use, or 0 for one per hardware thread.
+ * @param options Settings for the parse. Only `options.maxDepth` and `options.validateUTF8` apply.
+ * @return A JSONValue object representing the parsed JSON.
+ * @throws std::runtime_error If the input is not valid JSON.
+ */
+JSONValue JSON::ParseParallel(const std::string_view source, unsigned int threads, const ParseOptions& options)
+{
+  Lexer lexer(source, options.validateUTF8);
+  if (lexer.NextToken().type != TokenType::LEFT_BRACKET) return Parser::Parse(source, options);
+
+  const std::size_t open = lexer.Position() - 1;
+  std::vector<std::size_t> separators;
+  if (!lexer.SkipContainer(&separators)) throw std::runtime_error("Unexpected end of JSON");
+
+  // SkipContainer only balances brackets, so check that the array is closed by one.
+  // Mismatches inside an element are caught when the element is parsed.
+  const std::size_t close = lexer.Position() - 1;
+  if (source[close] != ']') throw std::runtime_error("Unexpected token type");
+  if (lexer.NextToken().type != TokenType::END_OF_FILE)
+  {
+    throw std::runtime_error("Unexpected data after end of JSON");
+  }
+
+  // The root array itself counts towards the depth limit, as in the sequential parse.
+  if (options.maxDepth == 0) throw Parser::DepthError(options.maxDepth);
+
+  // Element i spans from after boundary i to before boundary i + 1.
+  std::vector<std::size_t> boundaries;
+  boundaries.reserve(separators.size() + 2);
+  boundaries.push_back(open);
+  boundaries.insert(boundaries.end(), separators.begin(), separators.end());
+  boundaries.push_back(close);
+
+  auto element = [&](const std::size_t i)
+  {
+    return source.substr(boundaries[i] + 1, boundaries[i + 1] - boundaries[i] - 1);
+  };
+
+  // Like the sequential parser, accept a trailing comma but no other empty element.
+  std::size_t count = boundaries.size() - 1;
+  if (IsBlank(element(count - 1))) count--;
+
+  std::vector<JSONValue> result(count);
+  if (count == 0) return JSONValue{std::move(result)};
+
+  // Group consecutive elements into tasks of similar size.
+  threads = ThreadPool::Resolve(threads);
+  std::size_t taskSize = (close - open) / (static_cast<std::size_t>(threads) * 8);
+  if (taskSize < MinimumTaskSize) taskSize = MinimumTaskSize;
+
+  std::vector<std::size_t> taskStarts{0};
+  for (std::size_t i = 1; i < count; i++)
+  {
+    if (boundaries[i] - boundaries[taskStarts.back()] >= taskSize) taskStarts.push_back(i);
+  }
+  taskStarts.push_back(count);
+
+  const std::size_t tasks = taskStarts.size() - 1;
+  ThreadPool pool(static_cast<unsigned int>(std::min<std::size_t>(threads, tasks)));
+  pool.ParallelFor(tasks, [&](const std::size_t task)
+  {
+    for (std::size_t i = taskStarts[task]; i < taskStarts[task + 1]; i++)
+    {
+      const std::string_view text = element(i);
+      if (IsBlank(text)) throw std::runtime_error("Unexpected token type");
+      result[i] = Parser::ParseNested(text, options, 1);
+    }
+  });
+
+  return JSONValue{std::move(result)};
+}
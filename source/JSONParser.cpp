@@ -0,0 +1,20 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONParser.h"
+#include "Parser.h"
+
+void JSONParser::Parse(const std::string_view source, JSONDocument& document, const ParseOptions& options)
+{
+  Parser::Parse(source, document, options, *this);
+}
+
+/**
+ * A tape is written without any scratch space; its two buffers are only reallocated when
+ * `source` is larger than any source parsed onto it before.
+ */
+void JSONParser::Parse(const std::string_view source, JSONTape& tape, const ParseOptions& options)
+{
+  Parser::Parse(source, tape, options);
+}
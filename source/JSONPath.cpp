@@ -0,0 +1,350 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONPath.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+/**
+ * Parses a non-negative decimal array index. Returns false unless all of `text` is one.
+ */
+static bool ParseIndex(const std::string_view text, std::size_t& index)
+{
+  if (text.empty()) return false;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), index);
+  return error == std::errc() && end == text.data() + text.size();
+}
+
+static std::runtime_error InvalidPath(const std::string_view expression)
+{
+  return std::runtime_error("Invalid JSON path: " + std::string(expression));
+}
+
+JSONPath::JSONPath(const std::string_view expression)
+{
+  if (!expression.empty() && expression.front() == '$') CompilePath(expression);
+  else CompilePointer(expression);
+}
+
+/**
+ * Splits a JSON Pointer at its slashes and decodes `~1` and `~0` in every token. Tokens that
+ * are valid array indices (no sign, no leading zero) also select elements of arrays.
+ */
+void JSONPath::CompilePointer(const std::string_view expression)
+{
+  if (expression.empty()) return; // The whole document
+  if (expression.front() != '/') throw InvalidPath(expression);
+
+  std::size_t start = 1;
+  while (true)
+  {
+    const std::size_t slash = std::min(expression.find('/', start), expression.size());
+    const std::string_view token = expression.substr(start, slash - start);
+
+    std::string key;
+    key.reserve(token.size());
+    for (std::size_t i = 0; i < token.size(); i++)
+    {
+      if (token[i] != '~')
+      {
+        key += token[i];
+        continue;
+      }
+
+      const char escape = i + 1 < token.size() ? token[++i] : '\0';
+      if (escape == '0') key += '~';
+      else if (escape == '1') key += '/';
+      else throw InvalidPath(expression);
+    }
+
+    std::size_t index;
+    const bool numeric = ParseIndex(key, index) && (key.size() == 1 || key.front() != '0');
+    AddMember(std::move(key));
+    if (numeric) m_steps.back().begin = index;
+
+    if (slash == expression.size()) return;
+    start = slash + 1;
+  }
+}
+
+/**
+ * Compiles the `$.name`, `['name']`, `[3]`, `[*]` and `[begin:end]` subset of JSONPath.
+ */
+void JSONPath::CompilePath(const std::string_view expression)
+{
+  std::size_t i = 1; // Skip the '$'
+  while (i < expression.size())
+  {
+    if (expression[i] == '.')
+    {
+      const std::size_t start = ++i;
+      while (i < expression.size() && expression[i] != '.' && expression[i] != '[') i++;
+      const std::string_view name = expression.substr(start, i - start);
+      if (name.empty()) throw InvalidPath(expression);
+
+      if (name == "*")
+      {
+        m_steps.push_back({StepKind::Wildcard, {}, 0, 0, NoIndex});
+        m_singular = false;
+      }
+      else AddMember(std::string(name));
+      continue;
+    }
+
+    if (expression[i] != '[' || ++i == expression.size()) throw InvalidPath(expression);
+
+    if (expression[i] == '\'' || expression[i] == '"')
+    {
+      // Quoted member name; a backslash takes the next character literally.
+      const char quote = expression[i++];
+      std::string key;
+      while (i < expression.size() && expression[i] != quote)
+      {
+        if (expression[i] == '\\' && i + 1 < expression.size()) i++;
+        key += expression[i++];
+      }
+      if (i + 1 >= expression.size() || expression[i + 1] != ']') throw InvalidPath(expression);
+      AddMember(std::move(key));
+      i += 2;
+      continue;
+    }
+
+    const std::size_t close = expression.find(']', i);
+    if (close == std::string_view::npos) throw InvalidPath(expression);
+    const std::string_view selector = expression.substr(i, close - i);
+    i = close + 1;
+
+    if (selector == "*")
+    {
+      m_steps.push_back({StepKind::Wildcard, {}, 0, 0, NoIndex});
+      m_singular = false;
+      continue;
+    }
+
+    const std::size_t colon = selector.find(':');
+    if (colon == std::string_view::npos)
+    {
+      std::size_t index;
+      if (!ParseIndex(selector, index)) throw InvalidPath(expression);
+      m_steps.push_back({StepKind::Index, {}, 0, index, index + 1});
+      continue;
+    }
+
+    const std::string_view first = selector.substr(0, colon);
+    const std::string_view last = selector.substr(colon + 1);
+    std::size_t begin = 0;
+    std::size_t end = NoIndex;
+    if (!first.empty() && !ParseIndex(first, begin)) throw InvalidPath(expression);
+    if (!last.empty() && !ParseIndex(last, end)) throw InvalidPath(expression);
+    m_steps.push_back({StepKind::Slice, {}, 0, begin, end});
+    m_singular = false;
+  }
+}
+
+void JSONPath::AddMember(std::string key)
+{
+  const std::size_t hash = JSONObject::Hash(key);
+  m_steps.push_back({StepKind::Member, std::move(key), hash, NoIndex, NoIndex});
+}
+
+/**
+ * Walks a tree, calling `visitor` for every value the path selects until it returns false.
+ * @return False if the visitor asked to stop.
+ */
+template <typename Visitor>
+bool JSONPath::Visit(const JSONValue& value, const std::size_t step, Visitor& visitor) const
+{
+  if (step == m_steps.size()) return visitor(value);
+  const Step& current = m_steps[step];
+
+  if (value.IsJSONObject())
+  {
+    const JSONObject& object = std::get<JSONObject>(value.data);
+    if (current.kind == StepKind::Member)
+    {
+      const auto member = object.find(current.key, current.hash);
+      return member == object.end() || Visit(member->Value(), step + 1, visitor);
+    }
+    if (current.kind == StepKind::Wildcard)
+    {
+      for (const auto& member : object)
+      {
+        if (!Visit(member.Value(), step + 1, visitor)) return false;
+      }
+    }
+    return true;
+  }
+
+  if (value.IsJSONArray() && current.begin != NoIndex)
+  {
+    const auto& array = std::get<std::vector<JSONValue>>(value.data);
+    const std::size_t end = current.kind == StepKind::Member ? current.begin + 1 : std::min(current.end, array.size());
+    for (std::size_t i = current.begin; i < end && i < array.size(); i++)
+    {
+      if (!Visit(array[i], step + 1, visitor)) return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Walks raw text. `first` is the already lexed first token of the value; unless the visitor
+ * asks to stop, the lexer is left just after the value. Containers off the path are skipped
+ * by matching brackets, and an array is left as soon as the rest of it cannot match.
+ * A key that occurs more than once selects its last value, as in the parsed tree, so the
+ * value of a matching member is only visited once the end of its object has been seen.
+ * @return False if the visitor asked to stop.
+ */
+template <typename Visitor>
+bool JSONPath::Visit(Lexer& lexer, const Token& first, const std::string_view source, const bool validateUTF8, const std::size_t step,
+                     Visitor& visitor) const
+{
+  if (step == m_steps.size())
+  {
+    JSONCursor cursor;
+    cursor.m_text = source.substr(first.Begin() - source.data());
+    cursor.m_validateUTF8 = validateUTF8;
+    if (!visitor(cursor)) return false;
+    lexer.SkipValue(first);
+    return true;
+  }
+  const Step& current = m_steps[step];
+
+  if (first.type == TokenType::LEFT_BRACE)
+  {
+    if (current.kind != StepKind::Member && current.kind != StepKind::Wildcard)
+    {
+      lexer.SkipValue(first);
+      return true;
+    }
+
+    Token token = lexer.NextToken();
+    if (token.type == TokenType::RIGHT_BRACE) return true;
+
+    std::string unescaped;
+    const char* lastMatch = nullptr;
+    while (true)
+    {
+      if (token.type != TokenType::STRING) throw std::runtime_error("Unexpected token type");
+
+      bool match = current.kind == StepKind::Wildcard;
+      if (!match && !token.escaped) match = token.value == current.key;
+      else if (!match)
+      {
+        unescaped.resize(token.value.size());
+        unescaped.resize(Parser::Unescape(token.value, unescaped.data()));
+        match = unescaped == current.key;
+      }
+
+      if (lexer.NextToken().type != TokenType::COLON) throw std::runtime_error("Unexpected token type");
+
+      const Token value = lexer.NextToken();
+      if (!match) lexer.SkipValue(value);
+      else if (current.kind == StepKind::Member)
+      {
+        lastMatch = value.Begin();
+        lexer.SkipValue(value);
+      }
+      else if (!Visit(lexer, value, source, validateUTF8, step + 1, visitor)) return false;
+
+      if (!lexer.NextSeparator(TokenType::RIGHT_BRACE)) break;
+      token = lexer.NextToken();
+    }
+
+    if (lastMatch == nullptr) return true;
+
+    // Lex the chosen value again, from its own position.
+    Lexer member(source.substr(lastMatch - source.data()), validateUTF8);
+    const Token value = member.NextToken();
+    return Visit(member, value, source, validateUTF8, step + 1, visitor);
+  }
+
+  if (first.type == TokenType::LEFT_BRACKET)
+  {
+    const std::size_t end = current.kind == StepKind::Member ? current.begin + 1 : current.end;
+    if (current.begin == NoIndex || current.begin >= end)
+    {
+      lexer.SkipValue(first);
+      return true;
+    }
+
+    Token token = lexer.NextToken();
+    if (token.type == TokenType::RIGHT_BRACKET) return true;
+
+    for (std::size_t i = 0; ; i++)
+    {
+      if (i < current.begin) lexer.SkipValue(token);
+      else if (!Visit(lexer, token, source, validateUTF8, step + 1, visitor)) return false;
+
+      if (i + 1 >= end)
+      {
+        // The rest of the array lies past the end of the selection.
+        if (!lexer.SkipContainer()) throw std::runtime_error("Unexpected end of JSON");
+        return true;
+      }
+
+      if (!lexer.NextSeparator(TokenType::RIGHT_BRACKET)) return true;
+      token = lexer.NextToken();
+    }
+  }
+
+  lexer.SkipValue(first);
+  return true;
+}
+
+template <typename Visitor>
+void JSONPath::VisitSource(const std::string_view source, const bool validateUTF8, Visitor& visitor) const
+{
+  Lexer lexer(source, validateUTF8);
+  const Token first = lexer.NextToken();
+  if (first.type != TokenType::END_OF_FILE) Visit(lexer, first, source, validateUTF8, 0, visitor);
+}
+
+const JSONValue& JSONPath::Get(const JSONValue& root) const
+{
+  const JSONValue* result = &JSONValue::nullValue;
+  auto visitor = [&result](const JSONValue& value) { result = &value; return false; };
+  Visit(root, 0, visitor);
+  return *result;
+}
+
+JSONCursor JSONPath::Get(const std::string_view source, const ParseOptions& options) const
+{
+  JSONCursor result;
+  auto visitor = [&result](const JSONCursor& cursor) { result = cursor; return false; };
+  VisitSource(source, options.validateUTF8, visitor);
+  return result;
+}
+
+void JSONPath::Select(const JSONValue& root, const std::function<void(const JSONValue&)>& callback) const
+{
+  auto visitor = [&callback](const JSONValue& value) { callback(value); return true; };
+  Visit(root, 0, visitor);
+}
+
+void JSONPath::Select(const std::string_view source, const std::function<void(const JSONCursor&)>& callback,
+                      const ParseOptions& options) const
+{
+  auto visitor = [&callback](const JSONCursor& cursor) { callback(cursor); return true; };
+  VisitSource(source, options.validateUTF8, visitor);
+}
+
+std::vector<const JSONValue*> JSONPath::SelectAll(const JSONValue& root) const
+{
+  std::vector<const JSONValue*> results;
+  auto visitor = [&results](const JSONValue& value) { results.push_back(&value); return true; };
+  Visit(root, 0, visitor);
+  return results;
+}
+
+std::vector<JSONCursor> JSONPath::SelectAll(const std::string_view source, const ParseOptions& options) const
+{
+  std::vector<JSONCursor> results;
+  auto visitor = [&results](const JSONCursor& cursor) { results.push_back(cursor); return true; };
+  VisitSource(source, options.validateUTF8, visitor);
+  return results;
+}
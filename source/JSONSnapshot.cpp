@@ -0,0 +1,530 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONSnapshot.h"
+#include "JSON.h"
+#include "ValueBuilder.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  constexpr char Magic[8] = {'J', 'S', 'O', 'N', 'S', 'N', 'A', 'P'};
+  constexpr uint32_t Version = 1;
+  constexpr uint32_t ByteOrderMark = 0x01020304;
+
+  /// The JSONType values, plus integers small enough to be stored inside their slot.
+  enum class Tag : uint32_t
+  {
+    Null,
+    Double,   // Offset of the number / 8
+    Bool,     // 0 or 1
+    String,   // String index
+    Array,    // Offset of the body / 8
+    Object,   // Offset of the body / 8
+    Int64,    // Offset of the number / 8
+    UInt64,   // Offset of the number / 8
+    SmallInt  // The value, as an int32_t
+  };
+
+  struct Slot
+  {
+    Tag tag;
+    uint32_t value;
+  };
+  static_assert(sizeof(Slot) == 8);
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t size;
+    uint64_t strings; // Offset of the string end table
+    uint32_t stringCount;
+    uint32_t reserved;
+    Slot root;
+  };
+  static_assert(sizeof(Header) == 48);
+
+  /// Container bodies start with their element or member count, padded to 8 bytes.
+  constexpr uint64_t CountBytes = 8;
+
+  /// Object bodies then hold one 4-byte key index per member, padded to 8 bytes.
+  constexpr uint64_t KeyBytes(const uint64_t count) { return (count * 4 + 7) & ~uint64_t{7}; }
+
+  /**
+   * @class Encoder
+   * @brief Lays a JSONValue tree out as a snapshot in one growing buffer.
+   *
+   * A container reserves room for its children's slots, then fills them in one by one;
+   * the bodies of nested containers and 64-bit numbers are appended behind it as they
+   * are encoded. Everything is placed at a multiple of 8 bytes.
+   */
+  class Encoder
+  {
+  public:
+    std::string Run(const JSONValue& value)
+    {
+      m_out.resize(sizeof(Header));
+      Header header{};
+      header.root = Encode(value);
+      std::memcpy(header.magic, Magic, sizeof(Magic));
+      header.version = Version;
+      header.byteOrder = ByteOrderMark;
+
+      // String table: the end offset of every string, then all of their bytes.
+      header.strings = m_out.size();
+      header.stringCount = static_cast<uint32_t>(m_strings.size());
+      uint64_t end = 0;
+      for (const std::string_view string : m_strings)
+      {
+        end += string.size();
+        m_out.append(reinterpret_cast<const char*>(&end), sizeof(end));
+      }
+      for (const std::string_view string : m_strings) m_out.append(string);
+
+      header.size = m_out.size();
+      std::memcpy(m_out.data(), &header, sizeof(header));
+      return std::move(m_out);
+    }
+
+  private:
+    std::string m_out;
+    std::unordered_map<std::string_view, uint32_t> m_index;
+    std::vector<std::string_view> m_strings;
+
+    // An array or object whose children are being encoded. `keys` is 0 for an array, whose
+    // body never starts at offset 0, and `members` holds an object's members sorted by key.
+    struct Frame
+    {
+      const JSONValue* container;
+      std::vector<const JSONObject::value_type*> members;
+      uint64_t keys;
+      uint64_t slots;
+      std::size_t next;
+      std::size_t count;
+    };
+    std::vector<Frame> m_stack;
+
+    /// Reserve `bytes` zeroed bytes and return their offset / 8.
+    uint32_t Reserve(const std::size_t bytes)
+    {
+      const uint64_t offset = m_out.size();
+      if (offset / 8 > UINT32_MAX) throw std::runtime_error("Document is too large for a JSON snapshot");
+      m_out.resize(m_out.size() + bytes);
+      return static_cast<uint32_t>(offset / 8);
+    }
+
+    template <typename T>
+    void Store(const uint64_t offset, const T& value)
+    {
+      std::memcpy(m_out.data() + offset, &value, sizeof(value));
+    }
+
+    template <typename T>
+    Slot Number(const Tag tag, const T value)
+    {
+      const uint32_t position = Reserve(sizeof(value));
+      Store(uint64_t{position} * 8, value);
+      return {tag, position};
+    }
+
+    uint32_t Intern(const std::string_view string)
+    {
+      const auto [entry, inserted] = m_index.try_emplace(string, static_cast<uint32_t>(m_strings.size()));
+      if (inserted) m_strings.push_back(string);
+      return entry->second;
+    }
+
+    /**
+     * Encodes a value and everything inside it, in the order a depth-first walk visits them.
+     * A container's slot is known as soon as its body is reserved, so the containers whose
+     * children are still being encoded wait on m_stack rather than the call stack.
+     */
+    Slot Encode(const JSONValue& value)
+    {
+      m_stack.clear();
+      const Slot root = Open(value);
+
+      while (!m_stack.empty())
+      {
+        Frame& frame = m_stack.back();
+        if (frame.next == frame.count)
+        {
+          m_stack.pop_back();
+          continue;
+        }
+
+        const std::size_t i = frame.next++;
+        const uint64_t slot = frame.slots + i * sizeof(Slot);
+        const JSONValue* child;
+        if (frame.keys == 0) child = &std::get<std::vector<JSONValue>>(frame.container->data)[i];
+        else
+        {
+          Store(frame.keys + i * 4, Intern(frame.members[i]->Key()));
+          child = &frame.members[i]->Value();
+        }
+
+        Store(slot, Open(*child)); // May push a frame, so `frame` is not used past this point
+      }
+      return root;
+    }
+
+    /**
+     * Encodes a scalar completely. For an array or object, reserves its body, stores the count
+     * and pushes a frame that fills in the children.
+     */
+    Slot Open(const JSONValue& value)
+    {
+      if (value.IsDouble()) return Number(Tag::Double, std::get<double>(value.data));
+      if (value.IsUInt64()) return Number(Tag::UInt64, std::get<uint64_t>(value.data));
+      if (value.IsBool()) return {Tag::Bool, std::get<bool>(value.data) ? 1u : 0u};
+      if (value.IsString()) return {Tag::String, Intern(std::get<std::string>(value.data))};
+
+      if (value.IsInt64())
+      {
+        const int64_t integer = std::get<int64_t>(value.data);
+        if (integer < INT32_MIN || integer > INT32_MAX) return Number(Tag::Int64, integer);
+        return {Tag::SmallInt, static_cast<uint32_t>(static_cast<int32_t>(integer))};
+      }
+
+      if (value.IsJSONArray())
+      {
+        const auto& array = std::get<std::vector<JSONValue>>(value.data);
+        const uint32_t position = Reserve(CountBytes + array.size() * sizeof(Slot));
+        const uint64_t body = uint64_t{position} * 8;
+        Store(body, static_cast<uint64_t>(array.size()));
+        m_stack.push_back({&value, {}, 0, body + CountBytes, 0, array.size()});
+        return {Tag::Array, position};
+      }
+
+      if (value.IsJSONObject())
+      {
+        const JSONObject& object = std::get<JSONObject>(value.data);
+        std::vector<const JSONObject::value_type*> members;
+        members.reserve(object.size());
+        for (const auto& member : object) members.push_back(&member);
+        std::sort(members.begin(), members.end(), [](const auto* a, const auto* b) { return a->Key() < b->Key(); });
+
+        const uint32_t position = Reserve(CountBytes + KeyBytes(members.size()) + members.size() * sizeof(Slot));
+        const uint64_t body = uint64_t{position} * 8;
+        const uint64_t values = body + CountBytes + KeyBytes(members.size());
+        Store(body, static_cast<uint64_t>(members.size()));
+        const std::size_t count = members.size();
+        m_stack.push_back({&value, std::move(members), body + CountBytes, values, 0, count});
+        return {Tag::Object, position};
+      }
+
+      return {Tag::Null, 0};
+    }
+  };
+}
+
+/**
+ * @struct JSONSnapshotImage
+ * @brief The validated bytes of a snapshot, shared by the JSONSnapshot and its copies.
+ */
+struct JSONSnapshotImage
+{
+  std::shared_ptr<const void> owner; // Keeps the bytes alive, e.g. a file mapping
+  const char* data = nullptr;
+  uint64_t size = 0;
+  uint64_t stringEnds = 0; // Offset of the string end table
+  const char* strings = nullptr;
+  uint64_t stringBytes = 0;
+  uint32_t stringCount = 0;
+
+  template <typename T>
+  [[nodiscard]] T Read(const uint64_t offset) const
+  {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+  }
+
+  /// Throws unless `bytes` bytes at `offset` lie between the header and the string table.
+  void Check(const uint64_t offset, const uint64_t bytes) const
+  {
+    if (offset < sizeof(Header) || offset > stringEnds || bytes > stringEnds - offset) throw std::runtime_error("Corrupt JSON snapshot");
+  }
+
+  [[nodiscard]] std::string_view String(const uint32_t index) const
+  {
+    if (index >= stringCount) throw std::runtime_error("Corrupt JSON snapshot");
+    const uint64_t begin = index == 0 ? 0 : Read<uint64_t>(stringEnds + (index - 1) * sizeof(uint64_t));
+    const uint64_t end = Read<uint64_t>(stringEnds + index * sizeof(uint64_t));
+    if (begin > end || end > stringBytes) throw std::runtime_error("Corrupt JSON snapshot");
+    return {strings + begin, static_cast<std::size_t>(end - begin)};
+  }
+};
+
+/**
+ * Reads the slot at `offset` into a handle, fetching 64-bit numbers and container counts
+ * and checking that whatever the slot refers to lies inside the snapshot.
+ */
+JSONSnapshotValue JSONSnapshotValue::Load(const JSONSnapshotImage* image, const uint64_t offset)
+{
+  const auto slot = image->Read<Slot>(offset);
+  const uint64_t position = uint64_t{slot.value} * 8;
+
+  JSONSnapshotValue value;
+  value.m_image = image;
+  switch (slot.tag)
+  {
+    case Tag::Null:
+      break;
+
+    case Tag::Double:
+    case Tag::Int64:
+    case Tag::UInt64:
+      image->Check(position, sizeof(uint64_t));
+      value.m_type = static_cast<uint8_t>(slot.tag);
+      value.m_payload = image->Read<uint64_t>(position);
+      break;
+
+    case Tag::SmallInt:
+      value.m_type = Int64;
+      value.m_payload = std::bit_cast<uint64_t>(int64_t{static_cast<int32_t>(slot.value)});
+      break;
+
+    case Tag::Bool:
+      value.m_type = Bool;
+      value.m_payload = slot.value != 0;
+      break;
+
+    case Tag::String:
+      if (slot.value >= image->stringCount) throw std::runtime_error("Corrupt JSON snapshot");
+      value.m_type = String;
+      value.m_size = slot.value;
+      break;
+
+    case Tag::Array:
+    case Tag::Object:
+    {
+      // Bodies always follow the slot that refers to them, so a corrupt file cannot form a cycle.
+      if (position <= offset) throw std::runtime_error("Corrupt JSON snapshot");
+      image->Check(position, CountBytes);
+      const auto count = image->Read<uint64_t>(position);
+      if (count > UINT32_MAX) throw std::runtime_error("Corrupt JSON snapshot");
+      const uint64_t keys = slot.tag == Tag::Object ? KeyBytes(count) : 0;
+      image->Check(position, CountBytes + keys + count * sizeof(Slot));
+
+      value.m_type = static_cast<uint8_t>(slot.tag);
+      value.m_size = static_cast<uint32_t>(count);
+      value.m_payload = position;
+      break;
+    }
+
+    default: throw std::runtime_error("Corrupt JSON snapshot");
+  }
+  return value;
+}
+
+std::size_t JSONSnapshotValue::Size() const
+{
+  if (!IsJSONArray() && !IsJSONObject()) throw std::runtime_error("Cannot take the size of a non-container JSON value");
+  return m_size;
+}
+
+JSONSnapshotValue JSONSnapshotValue::operator[](const int index) const
+{
+  if (!IsJSONArray()) throw std::runtime_error("Cannot access element of non-array JSON value");
+  if (index < 0 || static_cast<uint32_t>(index) >= m_size) return {};
+  return Load(m_image, m_payload + CountBytes + static_cast<uint64_t>(index) * sizeof(Slot));
+}
+
+/**
+ * Binary search over the object's keys, which the encoder sorted by their bytes.
+ */
+JSONSnapshotValue JSONSnapshotValue::operator[](const std::string_view key) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+
+  uint32_t low = 0;
+  uint32_t high = m_size;
+  while (low < high)
+  {
+    const uint32_t middle = low + (high - low) / 2;
+    const int order = m_image->String(m_image->Read<uint32_t>(m_payload + CountBytes + middle * 4)).compare(key);
+    if (order == 0) return Load(m_image, m_payload + CountBytes + KeyBytes(m_size) + middle * sizeof(Slot));
+    if (order < 0) low = middle + 1;
+    else high = middle;
+  }
+  return {};
+}
+
+std::string_view JSONSnapshotValue::KeyAt(const std::size_t index) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  if (index >= m_size) throw std::out_of_range("JSONSnapshotValue::KeyAt: index out of range");
+  return m_image->String(m_image->Read<uint32_t>(m_payload + CountBytes + index * 4));
+}
+
+JSONSnapshotValue JSONSnapshotValue::ValueAt(const std::size_t index) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  if (index >= m_size) throw std::out_of_range("JSONSnapshotValue::ValueAt: index out of range");
+  return Load(m_image, m_payload + CountBytes + KeyBytes(m_size) + index * sizeof(Slot));
+}
+
+std::string_view JSONSnapshotValue::AsString() const
+{
+  if (IsNull()) return {};
+  if (!IsString()) throw std::runtime_error("Cannot convert non-string JSON value to string");
+  return m_image->String(m_size);
+}
+
+double JSONSnapshotValue::AsDouble() const
+{
+  switch (m_type)
+  {
+    case Null:   return 0.0;
+    case Double: return std::bit_cast<double>(m_payload);
+    case Int64:  return static_cast<double>(std::bit_cast<int64_t>(m_payload));
+    case UInt64: return static_cast<double>(m_payload);
+    default: throw std::runtime_error("Cannot convert non-double JSON value to double");
+  }
+}
+
+int64_t JSONSnapshotValue::AsInt64() const
+{
+  switch (m_type)
+  {
+    case Null:   return 0;
+    case Int64:  return std::bit_cast<int64_t>(m_payload);
+    case Double: return static_cast<int64_t>(std::bit_cast<double>(m_payload));
+    case UInt64:
+      if (m_payload > static_cast<uint64_t>(INT64_MAX)) throw std::runtime_error("JSON integer does not fit in int64_t");
+      return static_cast<int64_t>(m_payload);
+    default: throw std::runtime_error("Cannot convert non-number JSON value to int64_t");
+  }
+}
+
+uint64_t JSONSnapshotValue::AsUInt64() const
+{
+  switch (m_type)
+  {
+    case Null:   return 0;
+    case UInt64: return m_payload;
+    case Double: return static_cast<uint64_t>(std::bit_cast<double>(m_payload));
+    case Int64:
+      if (std::bit_cast<int64_t>(m_payload) < 0) throw std::runtime_error("Negative JSON integer does not fit in uint64_t");
+      return m_payload;
+    default: throw std::runtime_error("Cannot convert non-number JSON value to uint64_t");
+  }
+}
+
+bool JSONSnapshotValue::AsBool() const
+{
+  if (IsNull()) return false;
+  if (!IsBool()) throw std::runtime_error("Cannot convert non-bool JSON value to bool");
+  return m_payload != 0;
+}
+
+JSONValue JSONSnapshotValue::ToJSONValue() const
+{
+  const auto shallow = [](const JSONSnapshotValue& value) -> JSONValue
+  {
+    switch (value.m_type)
+    {
+      case Double: return JSONValue{std::bit_cast<double>(value.m_payload)};
+      case Int64:  return JSONValue{std::bit_cast<int64_t>(value.m_payload)};
+      case UInt64: return JSONValue{value.m_payload};
+      case Bool:   return JSONValue{value.m_payload != 0};
+      case String: return JSONValue{std::string(value.AsString())};
+
+      case Array:
+      {
+        std::vector<JSONValue> array;
+        array.reserve(value.m_size);
+        return JSONValue{std::move(array)};
+      }
+
+      case Object:
+      {
+        JSONObject object;
+        object.reserve(value.m_size);
+        return JSONValue{std::move(object)};
+      }
+
+      default: return {};
+    }
+  };
+
+  return BuildJSONValue(*this, shallow, [](const JSONSnapshotValue& container, const auto& add)
+  {
+    if (container.m_type == Array)
+    {
+      for (uint32_t i = 0; i < container.m_size; i++) add({}, container[static_cast<int>(i)]);
+    }
+    else
+    {
+      for (uint32_t i = 0; i < container.m_size; i++) add(container.KeyAt(i), container.ValueAt(i));
+    }
+  });
+}
+
+JSONSnapshotValue JSONSnapshot::Root() const
+{
+  if (m_image == nullptr) return {};
+  return JSONSnapshotValue::Load(m_image.get(), offsetof(Header, root));
+}
+
+std::size_t JSONSnapshot::StringCount() const
+{
+  return m_image == nullptr ? 0 : m_image->stringCount;
+}
+
+std::size_t JSONSnapshot::Size() const
+{
+  return m_image == nullptr ? 0 : m_image->size;
+}
+
+std::string JSONSnapshot::Encode(const JSONValue& value)
+{
+  Encoder encoder;
+  return encoder.Run(value);
+}
+
+/**
+ * Checks the header and the bounds of the string table. Everything else is checked as it is
+ * visited, so opening a snapshot takes the same time regardless of its size.
+ */
+JSONSnapshot JSONSnapshot::View(const std::string_view data, std::shared_ptr<const void> owner)
+{
+  if (reinterpret_cast<std::uintptr_t>(data.data()) % alignof(uint64_t) != 0) throw std::runtime_error("JSON snapshot is not aligned to 8 bytes");
+  if (data.size() < sizeof(Header)) throw std::runtime_error("Not a JSON snapshot");
+
+  Header header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) throw std::runtime_error("Not a JSON snapshot");
+  if (header.byteOrder != ByteOrderMark) throw std::runtime_error("JSON snapshot was written with a different byte order");
+  if (header.version != Version) throw std::runtime_error("Unsupported JSON snapshot version");
+  if (header.size != data.size() || header.strings < sizeof(Header) || header.strings > data.size() ||
+      uint64_t{header.stringCount} > (data.size() - header.strings) / sizeof(uint64_t))
+  {
+    throw std::runtime_error("Corrupt JSON snapshot");
+  }
+
+  auto image = std::make_shared<JSONSnapshotImage>();
+  image->owner = std::move(owner);
+  image->data = data.data();
+  image->size = data.size();
+  image->stringEnds = header.strings;
+  image->stringCount = header.stringCount;
+  const uint64_t stringsStart = header.strings + uint64_t{header.stringCount} * sizeof(uint64_t);
+  image->strings = data.data() + stringsStart;
+  image->stringBytes = data.size() - stringsStart;
+
+  JSONSnapshot snapshot;
+  snapshot.m_image = std::move(image);
+  static_cast<void>(snapshot.Root()); // Validates the root slot
+  return snapshot;
+}
@@ -0,0 +1,241 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONStreamParser.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "StringScanner.h"
+#include <stdexcept>
+
+bool JSONStreamParser::Feed(const std::string_view chunk)
+{
+  m_buffer.append(chunk);
+
+  // A long string that spans many chunks is only searched from where the last chunk ended.
+  if (m_inString && !StringClosed()) return HasValue();
+
+  Lex(false);
+  return HasValue();
+}
+
+bool JSONStreamParser::Finish()
+{
+  Lex(true);
+
+  if (!m_buffer.empty() || !m_stack.empty() || m_state != State::Value)
+  {
+    throw std::runtime_error("Unexpected end of JSON");
+  }
+  return HasValue();
+}
+
+JSONValue JSONStreamParser::TakeValue()
+{
+  if (m_values.empty()) throw std::runtime_error("No complete JSON value available");
+
+  JSONValue value = std::move(m_values.front());
+  m_values.pop_front();
+  return value;
+}
+
+void JSONStreamParser::Reset()
+{
+  m_buffer.clear();
+  m_scanFrom = 0;
+  m_inString = false;
+  m_state = State::Value;
+  m_stack.clear();
+  m_values.clear();
+}
+
+/**
+ * Checks whether the string that starts at the front of the buffer has its closing quote yet.
+ * Escapes are stepped over as pairs, so a backslash at the end of the buffer is revisited
+ * once the escaped character arrives.
+ */
+bool JSONStreamParser::StringClosed()
+{
+  std::size_t i = m_scanFrom;
+  while (true)
+  {
+    i = m_buffer.find_first_of("\"\\", i);
+    if (i == std::string::npos)
+    {
+      m_scanFrom = m_buffer.size();
+      return false;
+    }
+    if (m_buffer[i] == '"') return true;
+    if (i + 1 >= m_buffer.size())
+    {
+      m_scanFrom = i;
+      return false;
+    }
+    i += 2;
+  }
+}
+
+/**
+ * Lexes the buffered input and consumes every complete token. A token that reaches the end
+ * of the buffer may still continue in the next chunk, so it is kept unless `final` is set.
+ * A chunk may also end inside a multibyte character, so strings are checked for valid UTF-8
+ * here, once they are complete, rather than by the lexer.
+ */
+void JSONStreamParser::Lex(const bool final)
+{
+  const std::string_view input = m_buffer;
+  Lexer lexer(input, false);
+  std::size_t consumed = input.size();
+
+  for (Token token = lexer.NextToken(); token.type != TokenType::END_OF_FILE; token = lexer.NextToken())
+  {
+    const char* end = token.value.data() + token.value.size();
+    const bool cutOff = end == input.data() + input.size();
+    const bool multiByte = token.type == TokenType::STRING || token.type == TokenType::INT ||
+                           token.type == TokenType::DOUBLE || token.type == TokenType::TRUE ||
+                           token.type == TokenType::FALSE || token.type == TokenType::NULL_TYPE ||
+                           token.type == TokenType::UNKNOWN;
+
+    // An unterminated string is never complete, other tokens are once the input is known to end.
+    if (multiByte && cutOff && (!final || token.type == TokenType::STRING))
+    {
+      const char* start = token.type == TokenType::STRING ? token.value.data() - 1 : token.value.data();
+      consumed = static_cast<std::size_t>(start - input.data());
+      break;
+    }
+
+    if (token.type == TokenType::STRING && m_validateUTF8 && !StringScanner::ValidUTF8(token.value.data(), token.value.size()))
+    {
+      throw std::runtime_error("Invalid UTF-8 in JSON string");
+    }
+    Consume(token);
+  }
+
+  m_buffer.erase(0, consumed);
+  m_inString = !m_buffer.empty() && m_buffer.front() == '"';
+  m_scanFrom = 1;
+  if (m_inString) StringClosed();
+}
+
+/**
+ * Advances the parse state machine by one token.
+ */
+void JSONStreamParser::Consume(const Token& token)
+{
+  switch (m_state)
+  {
+    case State::ValueOrEnd:
+      if (token.type == TokenType::RIGHT_BRACKET)
+      {
+        Close(true);
+        return;
+      }
+      BeginValue(token);
+      return;
+
+    case State::Value:
+      BeginValue(token);
+      return;
+
+    case State::KeyOrEnd:
+      if (token.type == TokenType::RIGHT_BRACE)
+      {
+        Close(false);
+        return;
+      }
+      if (token.type != TokenType::STRING) throw std::runtime_error("Unexpected token type");
+      m_stack.back().key.resize(token.value.size());
+      m_stack.back().key.resize(Parser::Unescape(token.value, m_stack.back().key.data()));
+      m_state = State::Colon;
+      return;
+
+    case State::Colon:
+      if (token.type != TokenType::COLON) throw std::runtime_error("Unexpected token type");
+      m_state = State::Value;
+      return;
+
+    case State::CommaOrEnd:
+      if (token.type == TokenType::COMMA)
+      {
+        m_state = m_stack.back().container.IsJSONArray() ? State::ValueOrEnd : State::KeyOrEnd;
+        return;
+      }
+      if (token.type == TokenType::RIGHT_BRACKET || token.type == TokenType::RIGHT_BRACE)
+      {
+        Close(token.type == TokenType::RIGHT_BRACKET);
+        return;
+      }
+      throw std::runtime_error("Unexpected token type");
+  }
+}
+
+void JSONStreamParser::BeginValue(const Token& token)
+{
+  if ((token.type == TokenType::LEFT_BRACE || token.type == TokenType::LEFT_BRACKET) && m_stack.size() >= m_maxDepth)
+  {
+    throw Parser::DepthError(m_maxDepth);
+  }
+
+  switch (token.type)
+  {
+    case TokenType::LEFT_BRACE:
+      m_stack.push_back(Frame{JSONValue{JSONObject()}, std::string()});
+      m_state = State::KeyOrEnd;
+      return;
+
+    case TokenType::LEFT_BRACKET:
+      m_stack.push_back(Frame{JSONValue{std::vector<JSONValue>()}, std::string()});
+      m_state = State::ValueOrEnd;
+      return;
+
+    case TokenType::STRING:
+    {
+      std::string value;
+      value.resize(token.value.size());
+      value.resize(Parser::Unescape(token.value, value.data()));
+      Complete(JSONValue{std::move(value)});
+      return;
+    }
+
+    case TokenType::INT:
+    case TokenType::DOUBLE: Complete(Parser::ParseNumberValue(token)); return;
+    case TokenType::TRUE: Complete(JSONValue{true}); return;
+    case TokenType::FALSE: Complete(JSONValue{false}); return;
+    case TokenType::NULL_TYPE: Complete(JSONValue{}); return;
+
+    default: throw std::runtime_error("Unexpected token type" + std::string(token.value));
+  }
+}
+
+/**
+ * Finishes the innermost container, checking that the closing token matches it.
+ */
+void JSONStreamParser::Close(const bool array)
+{
+  if (m_stack.empty() || m_stack.back().container.IsJSONArray() != array)
+  {
+    throw std::runtime_error("Unexpected token type");
+  }
+
+  JSONValue container = std::move(m_stack.back().container);
+  m_stack.pop_back();
+  Complete(std::move(container));
+}
+
+/**
+ * Adds a finished value to its parent, or queues it if it is a top-level value.
+ */
+void JSONStreamParser::Complete(JSONValue&& value)
+{
+  if (m_stack.empty())
+  {
+    m_values.push_back(std::move(value));
+    m_state = State::Value;
+    return;
+  }
+
+  Frame& parent = m_stack.back();
+  if (parent.container.IsJSONArray()) parent.container.AsArray().push_back(std::move(value));
+  else parent.container.AsObject()[std::move(parent.key)] = std::move(value);
+  m_state = State::CommaOrEnd;
+}
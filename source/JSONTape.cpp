@@ -0,0 +1,142 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONTape.h"
+#include "JSON.h"
+#include "ValueBuilder.h"
+
+using namespace JSONTapeDetail;
+
+std::size_t JSONElement::Size() const
+{
+  if (!IsJSONArray() && !IsJSONObject()) throw std::runtime_error("Cannot take the size of a non-container JSON value");
+
+  const uint64_t count = PayloadOf(Word()) >> 32;
+  if (count < MaxCount) return count;
+
+  // Too many children to store in the word, so count them.
+  std::size_t size = 0;
+  if (IsJSONArray())
+  {
+    for (auto it = Elements().begin(), end = Elements().end(); it != end; ++it) size++;
+  }
+  else
+  {
+    for (auto it = Members().begin(), end = Members().end(); it != end; ++it) size++;
+  }
+  return size;
+}
+
+JSONElement JSONElement::operator[](const int index) const
+{
+  if (!IsJSONArray()) throw std::runtime_error("Cannot access element of non-array JSON value");
+  if (index < 0) return {};
+
+  int i = 0;
+  for (const JSONElement element : Elements())
+  {
+    if (i++ == index) return element;
+  }
+  return {};
+}
+
+/**
+ * Looks a member up by key. Members are stored in document order and searched linearly,
+ * stepping over the values of the ones that do not match. The tape can only be walked
+ * forwards, so the search goes on to the end of the object: a key that occurs more than
+ * once yields its last value, as in a JSONValue.
+ */
+JSONElement JSONElement::operator[](const std::string_view key) const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  JSONElement found;
+  for (const auto& member : Members())
+  {
+    if (member.key == key) found = member.value;
+  }
+  return found;
+}
+
+JSONElement::Range<JSONElement::Iterator> JSONElement::Elements() const
+{
+  if (!IsJSONArray()) throw std::runtime_error("Cannot access element of non-array JSON value");
+  return {Iterator(At(m_index + 1)), Iterator(At(Last()))};
+}
+
+JSONElement::Range<JSONElement::MemberIterator> JSONElement::Members() const
+{
+  if (!IsJSONObject()) throw std::runtime_error("Cannot access element of non-object JSON value");
+  return {MemberIterator(At(m_index + 1)), MemberIterator(At(Last()))};
+}
+
+int64_t JSONElement::AsInt64() const
+{
+  switch (Tag())
+  {
+    case Null:   return 0;
+    case Int64:  return static_cast<int64_t>(Number());
+    case Double: return static_cast<int64_t>(AsDouble());
+    case UInt64:
+      if (Number() > static_cast<uint64_t>(INT64_MAX)) throw std::runtime_error("JSON integer does not fit in int64_t");
+      return static_cast<int64_t>(Number());
+    default: throw std::runtime_error("Cannot convert non-number JSON value to int64_t");
+  }
+}
+
+uint64_t JSONElement::AsUInt64() const
+{
+  switch (Tag())
+  {
+    case Null:   return 0;
+    case UInt64: return Number();
+    case Double: return static_cast<uint64_t>(AsDouble());
+    case Int64:
+      if (static_cast<int64_t>(Number()) < 0) throw std::runtime_error("Negative JSON integer does not fit in uint64_t");
+      return Number();
+    default: throw std::runtime_error("Cannot convert non-number JSON value to uint64_t");
+  }
+}
+
+JSONValue JSONElement::ToJSONValue() const
+{
+  const auto shallow = [](const JSONElement element) -> JSONValue
+  {
+    switch (element.Tag())
+    {
+      case Double: return JSONValue{element.AsDouble()};
+      case Int64:  return JSONValue{static_cast<int64_t>(element.Number())};
+      case UInt64: return JSONValue{element.Number()};
+      case Bool:   return JSONValue{element.AsBool()};
+      case String: return JSONValue{std::string(element.AsString())};
+
+      case Array:
+      {
+        std::vector<JSONValue> array;
+        array.reserve(element.Size());
+        return JSONValue{std::move(array)};
+      }
+
+      case Object:
+      {
+        JSONObject object;
+        object.reserve(element.Size());
+        return JSONValue{std::move(object)};
+      }
+
+      default: return {};
+    }
+  };
+
+  return BuildJSONValue(*this, shallow, [](const JSONElement container, const auto& add)
+  {
+    if (container.Tag() == Array)
+    {
+      for (const JSONElement element : container.Elements()) add({}, element);
+    }
+    else
+    {
+      for (const auto& [key, value] : container.Members()) add(key, value);
+    }
+  });
+}
@@ -0,0 +1,56 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONTokenizer.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <new>
+
+JSONTokenizer::JSONTokenizer(const std::string_view source, const bool validateUTF8)
+{
+  static_assert(sizeof(Lexer) <= sizeof(m_storage) && alignof(Lexer) <= 8, "Grow JSONTokenizer::m_storage to fit the Lexer");
+  new (m_storage) Lexer(source, validateUTF8);
+}
+
+JSONTokenizer::~JSONTokenizer()
+{
+  GetLexer().~Lexer();
+}
+
+Token JSONTokenizer::NextToken()
+{
+  return GetLexer().NextToken();
+}
+
+void JSONTokenizer::SkipValue(const Token& first)
+{
+  GetLexer().SkipValue(first);
+}
+
+std::size_t JSONTokenizer::Unescape(const std::string_view value, char* out)
+{
+  return Parser::Unescape(value, out);
+}
+
+ParsedNumber JSONTokenizer::ParseNumber(const Token& token)
+{
+  return Parser::ParseNumber(token);
+}
+
+JSONValue JSONTokenizer::ParsePrefix(const std::string_view source, const bool validateUTF8)
+{
+  ParseOptions options;
+  options.validateUTF8 = validateUTF8;
+  return Parser::ParsePrefix(source, options);
+}
+
+std::runtime_error JSONTokenizer::DepthError(const std::size_t maxDepth)
+{
+  return Parser::DepthError(maxDepth);
+}
+
+Lexer& JSONTokenizer::GetLexer()
+{
+  return *std::launder(reinterpret_cast<Lexer*>(m_storage));
+}
@@ -0,0 +1,326 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "JSONWriter.h"
+#include "StringScanner.h"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <unistd.h>
+#elif __has_include(<io.h>)
+#include <io.h>
+#endif
+
+namespace
+{
+  /// For every byte that must be escaped, the letter of its escape sequence.
+  constexpr std::array<char, 256> EscapeTable = []()
+  {
+    std::array<char, 256> table{};
+    for (int c = 0; c < 0x20; c++) table[c] = 'u';
+    table['"'] = '"';
+    table['\\'] = '\\';
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    return table;
+  }();
+}
+
+JSONWriter::JSONWriter(std::string& buffer)
+  : m_sink(Sink::Buffer), m_out(&buffer), m_limit(SIZE_MAX)
+{
+}
+
+JSONWriter::JSONWriter(const int descriptor, const std::size_t chunkSize)
+  : m_sink(Sink::Descriptor), m_out(&m_chunk), m_chunkSize(chunkSize), m_limit(chunkSize), m_descriptor(descriptor)
+{
+  m_chunk.reserve(m_chunkSize);
+}
+
+JSONWriter::JSONWriter(std::ostream& stream, const std::size_t chunkSize)
+  : m_sink(Sink::Stream), m_out(&m_chunk), m_chunkSize(chunkSize), m_limit(chunkSize), m_stream(&stream)
+{
+  m_chunk.reserve(m_chunkSize);
+}
+
+JSONWriter::~JSONWriter()
+{
+  try
+  {
+    Flush();
+  }
+  catch (const std::runtime_error&)
+  {
+    // Destructors must not throw. Callers that care about errors call Flush() themselves.
+  }
+}
+
+/**
+ * Writes a JSONValue and everything inside it.
+ *
+ * Containers are opened onto m_stack instead of recursing, so a value nested deeper than
+ * the call stack could hold is written all the same. After each value, the loop either
+ * moves on to the next child of the innermost open container or closes that container.
+ */
+void JSONWriter::Write(const JSONValue& value)
+{
+  m_stack.clear(); // Left over if a previous write threw
+  const JSONValue* next = &value;
+
+  while (next != nullptr)
+  {
+    if (next->IsJSONArray())
+    {
+      Put('[');
+      m_stack.push_back({next, 0});
+    }
+    else if (next->IsJSONObject())
+    {
+      Put('{');
+      m_stack.push_back({next, 0});
+    }
+    else if (next->IsDouble()) WriteNumber(std::get<double>(next->data));
+    else if (next->IsInt64()) WriteNumber(std::get<int64_t>(next->data));
+    else if (next->IsUInt64()) WriteNumber(std::get<uint64_t>(next->data));
+    else if (next->IsBool()) WriteBool(std::get<bool>(next->data));
+    else if (next->IsString()) WriteString(std::get<std::string>(next->data));
+    else WriteNull();
+
+    next = nullptr;
+    while (next == nullptr && !m_stack.empty())
+    {
+      Frame& frame = m_stack.back();
+
+      if (frame.container->IsJSONArray())
+      {
+        const auto& array = std::get<std::vector<JSONValue>>(frame.container->data);
+        if (frame.next == array.size())
+        {
+          Put(']');
+          m_stack.pop_back();
+          continue;
+        }
+
+        if (frame.next > 0) Append(", ", 2);
+        next = &array[frame.next++];
+        continue;
+      }
+
+      const auto& object = std::get<JSONObject>(frame.container->data);
+      if (frame.next == object.size())
+      {
+        Put('}');
+        m_stack.pop_back();
+        continue;
+      }
+
+      if (frame.next > 0) Append(", ", 2);
+      const auto& [key, member] = *(object.begin() + static_cast<std::ptrdiff_t>(frame.next++));
+      WriteString(key);
+      Append(": ", 2);
+      next = &member;
+    }
+  }
+}
+
+/**
+ * Writes a read-only JSONNode and everything inside it, in the same format as a JSONValue.
+ * Like Write(const JSONValue&), it opens containers onto a stack rather than recursing.
+ */
+void JSONWriter::Write(const JSONNode& node)
+{
+  m_nodeStack.clear(); // Left over if a previous write threw
+  const JSONNode* next = &node;
+
+  while (next != nullptr)
+  {
+    switch (next->type)
+    {
+      case JSONType::Double: WriteNumber(next->number); break;
+      case JSONType::Int64: WriteNumber(next->integer); break;
+      case JSONType::UInt64: WriteNumber(next->unsignedInteger); break;
+      case JSONType::Bool: WriteBool(next->boolean); break;
+      case JSONType::String: WriteString(next->AsString()); break;
+      case JSONType::Array: Put('['); m_nodeStack.push_back({next, 0}); break;
+      case JSONType::Object: Put('{'); m_nodeStack.push_back({next, 0}); break;
+      default: WriteNull(); break;
+    }
+
+    next = nullptr;
+    while (next == nullptr && !m_nodeStack.empty())
+    {
+      NodeFrame& frame = m_nodeStack.back();
+      const bool isArray = frame.container->type == JSONType::Array;
+
+      if (frame.next == frame.container->size)
+      {
+        Put(isArray ? ']' : '}');
+        m_nodeStack.pop_back();
+        continue;
+      }
+
+      if (frame.next > 0) Append(", ", 2);
+      if (isArray)
+      {
+        next = &frame.container->elements[frame.next++];
+        continue;
+      }
+
+      const JSONMember& member = frame.container->members[frame.next++];
+      WriteString(member.key);
+      Append(": ", 2);
+      next = &member.value;
+    }
+  }
+}
+
+void JSONWriter::WriteNull()
+{
+  Append("null", 4);
+}
+
+void JSONWriter::WriteBool(const bool value)
+{
+  if (value) Append("true", 4);
+  else Append("false", 5);
+}
+
+/**
+ * Writes the shortest text that parses back to exactly the same double. Integral values
+ * get a ".0" so they are read back as a double rather than an integer.
+ */
+void JSONWriter::WriteNumber(const double value)
+{
+  if (!std::isfinite(value)) return WriteNull();
+
+  char buffer[32];
+  char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+
+  bool integral = true;
+  for (const char* c = buffer; c != end; c++) integral &= (*c >= '0' && *c <= '9') || *c == '-';
+  if (integral)
+  {
+    *end++ = '.';
+    *end++ = '0';
+  }
+  Append(buffer, static_cast<std::size_t>(end - buffer));
+}
+
+void JSONWriter::WriteNumber(const int64_t value)
+{
+  char buffer[24];
+  const char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+  Append(buffer, static_cast<std::size_t>(end - buffer));
+}
+
+void JSONWriter::WriteNumber(const uint64_t value)
+{
+  char buffer[24];
+  const char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+  Append(buffer, static_cast<std::size_t>(end - buffer));
+}
+
+/**
+ * Writes a quoted string. Runs of characters that need no escaping are found with a
+ * vectorized search and copied in one go; quotes, backslashes and control characters
+ * are replaced by their escape sequences.
+ */
+void JSONWriter::WriteString(const std::string_view value)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+
+  Put('"');
+  const char* data = value.data();
+  std::size_t i = 0;
+  while (true)
+  {
+    const std::size_t run = StringScanner::FindEscapable(data + i, value.size() - i);
+    Append(data + i, run);
+    i += run;
+    if (i == value.size()) break;
+
+    const auto c = static_cast<unsigned char>(data[i++]);
+    const char escape = EscapeTable[c];
+    if (escape == 'u')
+    {
+      const char sequence[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+      Append(sequence, 6);
+    }
+    else
+    {
+      const char sequence[2] = {'\\', escape};
+      Append(sequence, 2);
+    }
+  }
+  Put('"');
+}
+
+/**
+ * Writes text that is already valid JSON, without any checks.
+ */
+void JSONWriter::WriteRaw(const std::string_view text)
+{
+  Append(text.data(), text.size());
+}
+
+void JSONWriter::Flush()
+{
+  if (m_sink == Sink::Buffer || m_chunk.empty()) return;
+  WriteOut(m_chunk.data(), m_chunk.size());
+  m_chunk.clear();
+}
+
+/**
+ * In buffer mode m_limit is SIZE_MAX, so the sink needs no test of its own on this path.
+ */
+void JSONWriter::Append(const char* data, const std::size_t length)
+{
+  if (length > m_limit - m_out->size())
+  {
+    Flush();
+    // Too large to stage, so it bypasses the chunk.
+    if (length >= m_chunkSize) return WriteOut(data, length);
+  }
+  m_out->append(data, length);
+}
+
+void JSONWriter::Put(const char c)
+{
+  if (m_out->size() >= m_limit) Flush();
+  m_out->push_back(c);
+}
+
+/**
+ * Hands bytes to the descriptor or stream, retrying partial and interrupted writes.
+ */
+void JSONWriter::WriteOut(const char* data, std::size_t length)
+{
+  if (m_sink == Sink::Stream)
+  {
+    m_stream->write(data, static_cast<std::streamsize>(length));
+    if (!*m_stream) throw std::runtime_error("Could not write JSON to stream");
+    return;
+  }
+
+  while (length > 0)
+  {
+#if __has_include(<unistd.h>)
+    const ssize_t written = ::write(m_descriptor, data, length);
+    if (written < 0 && errno == EINTR) continue;
+#else
+    const int written = ::_write(m_descriptor, data, static_cast<unsigned int>(length));
+#endif
+    if (written <= 0) throw std::runtime_error("Could not write JSON to file descriptor");
+    data += written;
+    length -= static_cast<std::size_t>(written);
+  }
+}
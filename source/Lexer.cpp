@@ -3,6 +3,15 @@
 //
 
 #include "Lexer.h"
+#include "StringScanner.h"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+// Locale-independent character classes, as defined by the JSON grammar.
+static bool IsWhitespace(const char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+static bool IsDigit(const char c) { return c >= '0' && c <= '9'; }
+static bool IsAlpha(const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
 
 /**
  * Tokenizes the input source string into a series of tokens.
@@ -21,11 +30,11 @@ std::vector<Token> Lexer::Tokenize(const std::string_view& source)
   std::vector<Token> tokens;
   Lexer instance(source);
 
-  Token token = instance.nextToken();
+  Token token = instance.NextToken();
   while (token.type != TokenType::END_OF_FILE)
   {
     tokens.push_back(token);
-    token = instance.nextToken();
+    token = instance.NextToken();
   }
 
   // Remember the EOF token
@@ -34,19 +43,79 @@ std::vector<Token> Lexer::Tokenize(const std::string_view& source)
   return tokens;
 }
 
+/**
+ * Loads the character class bitmaps of the 64-byte block containing `index`.
+ *
+ * Blocks are aligned to the start of the source. The last, partial block is copied
+ * into a buffer padded with spaces so the kernels can always read a full block.
+ */
+void Lexer::LoadBlock(const std::size_t index)
+{
+  constexpr std::size_t blockSize = StructuralScanner::BlockSize;
+  m_blockStart = index - index % blockSize;
+
+  BlockMasks masks;
+  if (m_source.size() - m_blockStart >= blockSize)
+  {
+    masks = m_scan(m_source.data() + m_blockStart);
+  }
+  else
+  {
+    char padded[blockSize];
+    std::memset(padded, ' ', blockSize);
+    std::memcpy(padded, m_source.data() + m_blockStart, m_source.size() - m_blockStart);
+    masks = m_scan(padded);
+  }
+
+  // A quote is escaped when it is preceded by an odd number of backslashes, which may start
+  // in an earlier block. Blocks are nearly always loaded in order, so the parity is carried
+  // over from the previous block. Only after a jump over blocks that were never loaded is the
+  // run counted in the source; such a jump is made over a number, so the run is short.
+  bool carry = m_escapeCarry;
+  if (m_blockStart != m_carryBlock)
+  {
+    std::size_t run = 0;
+    while (run < m_blockStart && m_source[m_blockStart - 1 - run] == '\\') run++;
+    carry = (run % 2) == 1;
+  }
+  const uint64_t escaped = StructuralScanner::EscapedMask(masks.backslash, carry);
+  m_carryBlock = m_blockStart + blockSize;
+  m_escapeCarry = carry;
+
+  m_whitespace = masks.whitespace;
+  m_quotes = masks.quote & ~escaped;
+  m_backslashes = masks.backslash;
+  m_nonAscii = masks.nonAscii;
+  m_structurals = masks.structural;
+  m_delimiters = masks.whitespace | masks.structural | masks.quote;
+}
+
 /**
  * Skips over consecutive whitespace characters in the input source.
  *
  * This method advances the current parsing index past any sequence of
- * space (' ') characters in the source string. It stops at the first
- * non-whitespace character or when the end of the input source is reached.
+ * JSON whitespace (space, tab, newline, carriage return). Runs longer than
+ * a single byte are skipped a block at a time using the whitespace bitmap.
  */
 void Lexer::SkipWhitespace()
 {
-  while (m_index < m_source.size() && std::isspace(m_source[m_index]))
+  // Most tokens are separated by at most one space, so check that before touching the bitmaps.
+  if (m_index >= m_source.size() || !IsWhitespace(m_source[m_index])) return;
+
+  while (m_index < m_source.size())
   {
-    m_index++;
+    if (m_index - m_blockStart >= StructuralScanner::BlockSize) LoadBlock(m_index);
+
+    const uint64_t remaining = ~m_whitespace >> (m_index - m_blockStart);
+    if (remaining != 0)
+    {
+      m_index += std::countr_zero(remaining);
+      break;
+    }
+    m_index = m_blockStart + StructuralScanner::BlockSize;
   }
+
+  if (m_index > m_source.size()) m_index = m_source.size();
 }
 
 /**
@@ -61,7 +130,7 @@ void Lexer::SkipWhitespace()
  * @return The next token in the source input. If the end of the source
  *         is reached, a token of type END_OF_FILE is returned.
  */
-Token Lexer::nextToken()
+Token Lexer::NextToken()
 {
   SkipWhitespace();
 
@@ -84,20 +153,112 @@ Token Lexer::nextToken()
     case '-': return NumberToken();
 
     default:
-      if (std::isdigit(c)) return NumberToken();
-      if (std::isalpha(c)) return BoolOrNullToken();
+      if (IsDigit(c)) return NumberToken();
+      if (IsAlpha(c)) return BoolOrNullToken();
 
       return SimpleToken(TokenType::UNKNOWN);
   }
 }
 
+/**
+ * Skips the rest of a container without producing tokens.
+ *
+ * Only the unescaped quotes and structural characters of each block are visited:
+ * quotes toggle whether we are inside a string, and outside of strings brackets
+ * and braces adjust the nesting depth until the container is closed. The contents
+ * are not validated.
+ *
+ * @param separators If not null, receives the positions of the commas directly inside the
+ *                   container, i.e. the boundaries between its elements or members.
+ * @return True if the closing bracket was found, false if the source ended first.
+ */
+bool Lexer::SkipContainer(std::vector<std::size_t>* separators)
+{
+  std::size_t depth = 1;
+  bool inString = false;
+
+  while (m_index < m_source.size())
+  {
+    if (m_index - m_blockStart >= StructuralScanner::BlockSize) LoadBlock(m_index);
+
+    const std::size_t offset = m_index - m_blockStart;
+    uint64_t candidates = (m_quotes | m_structurals) >> offset;
+
+    while (candidates != 0)
+    {
+      const std::size_t position = m_index + std::countr_zero(candidates);
+      candidates &= candidates - 1;
+
+      switch (m_source[position])
+      {
+        case '"': inString = !inString; break;
+        case '{': case '[': if (!inString) depth++; break;
+        case '}': case ']':
+          if (!inString && --depth == 0)
+          {
+            m_index = position + 1;
+            return true;
+          }
+          break;
+        case ',':
+          if (!inString && depth == 1 && separators != nullptr) separators->push_back(position);
+          break;
+        default: break;
+      }
+    }
+
+    m_index = m_blockStart + StructuralScanner::BlockSize;
+  }
+
+  m_index = m_source.size();
+  return false;
+}
+
+/**
+ * Advances past the value that starts with `first`. Containers are skipped by matching
+ * braces and brackets, without lexing what is inside them.
+ */
+void Lexer::SkipValue(const Token& first)
+{
+  switch (first.type)
+  {
+    case TokenType::LEFT_BRACE:
+    case TokenType::LEFT_BRACKET:
+      break;
+
+    case TokenType::STRING:
+    case TokenType::INT:
+    case TokenType::DOUBLE:
+    case TokenType::TRUE:
+    case TokenType::FALSE:
+    case TokenType::NULL_TYPE:
+      return;
+
+    default:
+      throw std::runtime_error("Unexpected token type" + std::string(first.value));
+  }
+
+  if (!SkipContainer()) throw std::runtime_error("Unexpected end of JSON");
+}
+
+/**
+ * Reads the token after a value: a comma (returns true) or the expected closing token (returns false).
+ */
+bool Lexer::NextSeparator(const TokenType closing)
+{
+  const Token token = NextToken();
+  if (token.type == TokenType::COMMA) return true;
+  if (token.type != closing) throw std::runtime_error("Unexpected token type");
+  return false;
+}
+
 /**
  * Helper function for 1-char tokens (move index forward by one and return the token type)
  */
 
 Token Lexer::SimpleToken(TokenType type)
 {
-  const unsigned int start = m_index;
+  const std::size_t start = m_index;
   m_index++;
   return Token{type, m_source.substr(start, 1)};
 }
@@ -108,35 +269,55 @@ Token Lexer::SimpleToken(TokenType type)
  * This method identifies and extracts a substring between two double-quote characters
  * from the current index in the source. The initial and final quotes are skipped during
  * processing. If the quotes are properly balanced, a token of type `TokenType::STRING`
- * is returned with the extracted string value.
+ * is returned with the extracted string value. The closing quote is found by jumping
+ * to the next unescaped quote in the block bitmaps, and the token is flagged as
+ * escaped if any backslash was passed on the way. Likewise, the contents are only
+ * validated as UTF-8 if a non-ASCII byte was passed.
  *
  * @return A `Token` object with `TokenType::STRING`, representing the extracted string,
  *         or an incomplete token if the input source ends unexpectedly.
+ * @throws std::runtime_error If validation is on and the string is not valid UTF-8.
  */
 Token Lexer::StringToken()
 {
   m_index++; // Skip the initial quote "
-  const unsigned int start = m_index;
+  const std::size_t start = m_index;
+  bool escaped = false;
+  bool nonAscii = false;
 
   while (m_index < m_source.length())
   {
-    if (m_source[m_index] == '\\')
-    {
-      m_index += 2;
-      continue;
-    }
-    else if (m_source[m_index] == '"')
+    if (m_index - m_blockStart >= StructuralScanner::BlockSize) LoadBlock(m_index);
+
+    const uint64_t quotes = m_quotes >> (m_index - m_blockStart);
+    const uint64_t backslashes = m_backslashes >> (m_index - m_blockStart);
+    const uint64_t multiByte = m_nonAscii >> (m_index - m_blockStart);
+    if (quotes != 0)
     {
+      const int length = std::countr_zero(quotes);
+      const uint64_t before = (uint64_t{1} << length) - 1;
+      escaped |= (backslashes & before) != 0;
+      nonAscii |= (multiByte & before) != 0;
+      m_index += length;
       break;
     }
-    m_index++;
+    escaped |= backslashes != 0;
+    nonAscii |= multiByte != 0;
+    m_index = m_blockStart + StructuralScanner::BlockSize;
   }
 
+  if (m_index > m_source.length()) m_index = m_source.length();
+
   const std::string_view str = m_source.substr(start, m_index - start);
 
+  if (nonAscii && m_validateUTF8 && !StringScanner::ValidUTF8(str.data(), str.size()))
+  {
+    throw std::runtime_error("Invalid UTF-8 in JSON string");
+  }
+
   if (m_index < m_source.length()) m_index++; // Skip the final quote "
 
-  return Token{TokenType::STRING, str};
+  return Token{TokenType::STRING, str, escaped};
 }
 
 /**
@@ -151,12 +332,13 @@ Token Lexer::StringToken()
  */
 Token Lexer::NumberToken()
 {
-  const unsigned int start = m_index;
+  const std::size_t start = m_index;
+  bool integer = true;
 
   // Check if it was a negative number.
   if (m_source[m_index] == '-') m_index++;
 
-  while (m_index < m_source.length() && std::isdigit(m_source[m_index]))
+  while (m_index < m_source.length() && IsDigit(m_source[m_index]))
   {
     m_index++;
   }
@@ -164,34 +346,19 @@ Token Lexer::NumberToken()
   // Check if it's a decimal number
   if (m_index < m_source.length() && m_source[m_index] == '.')
   {
+    integer = false;
     m_index++; // Skip the decimal
 
-    while (m_index < m_source.length() && std::isdigit(m_source[m_index]))
+    while (m_index < m_source.length() && IsDigit(m_source[m_index]))
     {
       m_index++;
     }
-
-    if (m_index < m_source.length() && (m_source[m_index] == 'e' || m_source[m_index] == 'E'))
-    {
-      m_index++; // Eat the e/E
-
-      if (m_index < m_source.length() && (m_source[m_index] == '+' || m_source[m_index] == '-'))
-      {
-        m_index++; // Eat the sign
-      }
-
-      while (m_index < m_source.length() && std::isdigit(m_source[m_index]))
-      {
-        m_index++;
-      }
-    }
-
-    return Token(TokenType::DOUBLE, m_source.substr(start, m_index - start));
   }
 
   // Check if its scientific notation
   if (m_index < m_source.length() && (m_source[m_index] == 'e' || m_source[m_index] == 'E'))
   {
+    integer = false;
     m_index++; // Eat the e/E
 
     if (m_index < m_source.length() && (m_source[m_index] == '+' || m_source[m_index] == '-'))
@@ -199,23 +366,21 @@ Token Lexer::NumberToken()
       m_index++; // Eat the sign
     }
 
-    while (m_index < m_source.length() && std::isdigit(m_source[m_index]))
+    while (m_index < m_source.length() && IsDigit(m_source[m_index]))
     {
       m_index++;
     }
   }
 
-  return Token(TokenType::DOUBLE, m_source.substr(start, m_index - start));
-
-  // if it wasn't a decimal number, it's an integer.
-  return Token(TokenType::INT, m_source.substr(start, m_index - start));
+  // Without a fraction or an exponent, it's an integer.
+  return Token(integer ? TokenType::INT : TokenType::DOUBLE, m_source.substr(start, m_index - start));
 }
 
 /**
  * Extracts and returns a token representing a boolean value, null literal, or unknown.
  *
- * This method reads a sequence of alphanumeric characters from the input source
- * starting at the current index. If the sequence matches one of the keywords
+ * This method reads the literal up to the next whitespace, structural character
+ * or quote, as marked in the block bitmaps. If the sequence matches one of the keywords
  * "true", "false", or "null", a corresponding token is returned. If the sequence
  * does not match any of these literals, an UNKNOWN token is returned.
  *
@@ -224,13 +389,23 @@ Token Lexer::NumberToken()
  */
 Token Lexer::BoolOrNullToken()
 {
-  unsigned int start = m_index;
+  const std::size_t start = m_index;
 
-  while (m_index < m_source.length() && std::isalnum(m_source[m_index]))
+  while (m_index < m_source.length())
   {
-    m_index++;
+    if (m_index - m_blockStart >= StructuralScanner::BlockSize) LoadBlock(m_index);
+
+    const uint64_t delimiters = m_delimiters >> (m_index - m_blockStart);
+    if (delimiters != 0)
+    {
+      m_index += std::countr_zero(delimiters);
+      break;
+    }
+    m_index = m_blockStart + StructuralScanner::BlockSize;
   }
 
+  if (m_index > m_source.length()) m_index = m_source.length();
+
   const std::string_view str = m_source.substr(start, m_index - start);
   if (str == "true") return Token(TokenType::TRUE, str);
   if (str == "false") return Token(TokenType::FALSE, str);
@@ -4,6 +4,7 @@
 
 #pragma once
 #include "Token.h"
+#include "StructuralScanner.h"
 #include <vector>
 
 /**
@@ -13,21 +14,67 @@
  * The Lexer class is used to process input strings and generate a sequence
  * of tokens based on predefined token types. It serves as a foundational
  * component for parsing and analyzing structured input.
+ *
+ * Whitespace and string contents are skipped using the 64-byte character class
+ * bitmaps produced by the StructuralScanner, rather than one byte at a time.
+ *
+ * Unless told not to, the lexer also checks that every string is valid UTF-8. The bitmaps
+ * mark non-ASCII bytes, so an ASCII-only string costs nothing extra; any other string is
+ * handed to the vectorized StringScanner::ValidUTF8. Bytes outside strings need no check,
+ * because anything but ASCII there is already an UNKNOWN token.
  */
 class Lexer
 {
 public:
   static std::vector<Token> Tokenize(const std::string_view& source);
 
-private:
-  Lexer(const std::string_view& source) : m_source(source), m_index(0) {}
+  /// Throws std::runtime_error from NextToken() on a string that is not valid UTF-8, unless `validateUTF8` is false.
+  explicit Lexer(const std::string_view& source, const bool validateUTF8 = true)
+    : m_source(source), m_index(0), m_validateUTF8(validateUTF8), m_scan(StructuralScanner::Select()), m_blockStart(0)
+  {
+    if (!m_source.empty()) LoadBlock(0);
+  }
   ~Lexer() = default;
 
+  /// Lex and return the next token, END_OF_FILE once the source is exhausted.
+  Token NextToken();
+
+  /// Skip to just after the bracket that closes the container whose opening token was
+  /// the last one returned. Returns false if the source ends first.
+  /// If `separators` is given, the positions of the container's own commas are appended to it.
+  bool SkipContainer(std::vector<std::size_t>* separators = nullptr);
+
+  /// Skip the value whose first token, `first`, was the last one returned.
+  void SkipValue(const Token& first);
+
+  /// Read the comma (returns true) or the `closing` token (returns false) after a value.
+  bool NextSeparator(TokenType closing);
+
+  /// Position of the next character to be lexed.
+  [[nodiscard]] std::size_t Position() const { return m_index; }
+
+private:
   std::string_view m_source;
-  unsigned int m_index;
+  std::size_t m_index;
+  bool m_validateUTF8;
+
+  // Bitmaps of the 64-byte block starting at m_blockStart.
+  StructuralScanner::Kernel m_scan;
+  std::size_t m_blockStart;
+  uint64_t m_whitespace;
+  uint64_t m_quotes; // Unescaped quotes only
+  uint64_t m_backslashes;
+  uint64_t m_nonAscii;
+  uint64_t m_structurals;
+  uint64_t m_delimiters; // Whitespace, structurals and quotes; anything that ends a literal
+
+  // Whether the first byte of the block at m_carryBlock is escaped by a backslash run that
+  // ends the block before it.
+  std::size_t m_carryBlock = 0;
+  bool m_escapeCarry = false;
 
+  void LoadBlock(std::size_t index);
   void SkipWhitespace();
-  Token nextToken();
   Token SimpleToken(TokenType type);
   Token StringToken();
   Token NumberToken();
@@ -0,0 +1,123 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "MappedFile.h"
+#include <fstream>
+#include <stdexcept>
+
+#if __has_include(<sys/mman.h>)
+#define JSON_HAS_MMAP 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filepath, const Access access)
+{
+#if JSON_HAS_MMAP
+  const int descriptor = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0)
+  {
+    throw std::runtime_error("Could not open file");
+  }
+
+  struct stat status{};
+  if (::fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+  {
+    m_length = static_cast<std::size_t>(status.st_size);
+    void* mapping = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping != MAP_FAILED)
+    {
+      ::madvise(mapping, m_length, access == Access::Random ? MADV_RANDOM : MADV_SEQUENTIAL);
+      m_mapping = mapping;
+      m_view = std::string_view(static_cast<const char*>(mapping), m_length);
+    }
+  }
+
+  // Empty files cannot be mapped, and special files may not support it. Those are read
+  // through the descriptor that is already open: a pipe or FIFO cannot be opened again
+  // without losing its writer.
+  try
+  {
+    if (m_mapping == nullptr) ReadDescriptor(descriptor);
+  }
+  catch (...)
+  {
+    ::close(descriptor);
+    throw;
+  }
+  ::close(descriptor);
+#else
+  static_cast<void>(access);
+  ReadIntoBuffer(filepath);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if JSON_HAS_MMAP
+  if (m_mapping != nullptr) ::munmap(m_mapping, m_length);
+#endif
+}
+
+#if JSON_HAS_MMAP
+/**
+ * Reads from the descriptor until it ends. Pipes, FIFOs and files such as those in /proc
+ * report no size up front, so the buffer grows as the data arrives.
+ */
+void MappedFile::ReadDescriptor(const int descriptor)
+{
+  std::size_t length = 0;
+  m_buffer.resize(64 * 1024);
+  while (true)
+  {
+    if (length == m_buffer.size()) m_buffer.resize(m_buffer.size() * 2);
+    const ssize_t count = ::read(descriptor, m_buffer.data() + length, m_buffer.size() - length);
+    if (count == 0) break;
+    if (count < 0)
+    {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("Could not read file");
+    }
+    length += static_cast<std::size_t>(count);
+  }
+  m_buffer.resize(length);
+  m_view = m_buffer;
+}
+#endif
+
+/**
+ * Reads the whole file with one read into a buffer of the file's size. Streams whose size
+ * cannot be told up front are read in chunks until they end instead.
+ */
+void MappedFile::ReadIntoBuffer(const std::string& filepath)
+{
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file.is_open())
+  {
+    throw std::runtime_error("Could not open file");
+  }
+
+  file.seekg(0, std::ios::end);
+  const std::streamoff size = file.fail() ? -1 : static_cast<std::streamoff>(file.tellg());
+  if (size > 0)
+  {
+    m_buffer.resize(static_cast<std::size_t>(size));
+    file.seekg(0);
+    file.read(m_buffer.data(), size);
+    m_buffer.resize(static_cast<std::size_t>(file.gcount()));
+  }
+  else
+  {
+    file.clear();
+    char chunk[64 * 1024];
+    while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+    {
+      m_buffer.append(chunk, static_cast<std::size_t>(file.gcount()));
+    }
+  }
+  m_view = m_buffer;
+}
@@ -0,0 +1,46 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <string>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file's contents.
+ *
+ * Where mmap is available the file is mapped read-only and the kernel is told how it
+ * will be read, so no copy of the contents is ever made. Elsewhere, or if the
+ * mapping fails, the file is read into a single buffer sized up front. Pipes, FIFOs and
+ * other files without a known size are read into a buffer that grows until they end.
+ */
+class MappedFile
+{
+public:
+  /// How the contents will be read, passed on to the kernel as a readahead hint.
+  enum class Access
+  {
+    Sequential, // Parsing from front to back
+    Random      // Jumping around, as when navigating a binary snapshot
+  };
+
+  /// Open and map the file. Throws std::runtime_error if it cannot be opened.
+  explicit MappedFile(const std::string& filepath, Access access = Access::Sequential);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] std::string_view View() const { return m_view; }
+  [[nodiscard]] bool IsMapped() const { return m_mapping != nullptr; }
+
+private:
+  void* m_mapping = nullptr;
+  std::size_t m_length = 0;
+  std::string m_buffer; // Fallback storage when the file is not mapped
+  std::string_view m_view;
+
+  void ReadDescriptor(int descriptor);
+  void ReadIntoBuffer(const std::string& filepath);
+};
@@ -3,14 +3,30 @@
 //
 
 #include "Parser.h"
+#include "StringScanner.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
 #include <stdexcept>
 
+Parser::Parser(const std::vector<Token>& tokens)
+  : m_lexer(std::string_view()), m_tokens(&tokens), m_index(0),
+    m_current(tokens.empty() ? Token{TokenType::END_OF_FILE, ""} : tokens.front())
+{
+}
+
+Parser::Parser(const std::string_view& source, const bool validateUTF8)
+  : m_lexer(source, validateUTF8), m_tokens(nullptr), m_index(0), m_current(m_lexer.NextToken())
+{
+}
+
 /**
  * @brief Parses a sequence of tokens into a JSONValue.
  *
  * This method takes a vector of tokens representing a JSON input and attempts to parse them
  * into a structured JSONValue. It validates the sequence of tokens and ensures that the
- * input adheres to JSON syntax rules.
+ * input adheres to JSON syntax rules. The tokens are walked in place and never copied.
  *
  * @param Tokens A vector of Token objects representing the lexed JSON input.
  * @return A JSONValue object representing the parsed JSON structure.
@@ -19,245 +35,1038 @@
 JSONValue Parser::Parse(const std::vector<Token>& Tokens)
 {
   Parser instance(Tokens);
+  NoParseStats stats;
+  return instance.ParseRoot(stats);
+}
 
-  if (instance.Peek().type == TokenType::END_OF_FILE)
+/**
+ * @brief Parses JSON source text into a JSONValue in a single pass.
+ *
+ * Unlike the token vector overload, no token buffer is ever built: the parser pulls
+ * one token at a time from a Lexer over the source, so peak memory is the input plus
+ * the resulting tree.
+ *
+ * @param source The JSON-encoded text to parse.
+ * @return A JSONValue object representing the parsed JSON structure.
+ * @throws std::runtime_error If the input is not valid JSON.
+ */
+JSONValue Parser::Parse(const std::string_view& source)
+{
+  Parser instance(source);
+  NoParseStats stats;
+  return instance.ParseRoot(stats);
+}
+
+/**
+ * @brief Parses JSON source text into a JSONValue and reports what the parse spent its time and memory on.
+ *
+ * The same parse as the overload without statistics, instantiated with the CollectParseStats
+ * policy. That overload uses NoParseStats, whose hooks are empty, so it pays nothing for this one.
+ *
+ * @param source The JSON-encoded text to parse.
+ * @param stats Reset, then filled in; partially filled in if the parse throws.
+ * @return A JSONValue object representing the parsed JSON structure.
+ * @throws std::runtime_error If the input is not valid JSON.
+ */
+JSONValue Parser::Parse(const std::string_view& source, ParseStats& stats)
+{
+  stats = ParseStats();
+  stats.bytes = source.size();
+  CollectParseStats collector{stats};
+
+  JSONValue value;
   {
-    return {JSONValue()};
+    const CollectParseStats::Timer total(collector, &ParseStats::totalNanoseconds);
+    Parser instance(source);
+    collector.Count(instance.Peek());
+    value = instance.ParseRoot(collector);
   }
 
-  JSONValue value = instance.ParseValue();
+  stats.buildNanoseconds = stats.totalNanoseconds - stats.lexNanoseconds - stats.numberNanoseconds - stats.stringNanoseconds;
+  return value;
+}
+
+/**
+ * @brief Parses JSON source text into a JSONValue with the nesting limit and UTF-8
+ * validation set in `options`.
+ *
+ * The parse keeps its open containers on a stack of its own rather than on the call stack,
+ * so raising the limit only lets that stack grow on the heap; the other options do not
+ * apply to a JSONValue.
+ *
+ * @param source The JSON-encoded text to parse.
+ * @param options Settings for the parse, see ParseOptions.
+ * @return A JSONValue object representing the parsed JSON structure.
+ * @throws std::runtime_error If the input is not valid JSON, nests too deeply or, when
+ *         validation is on, contains a string that is not valid UTF-8.
+ */
+JSONValue Parser::Parse(const std::string_view& source, const ParseOptions& options)
+{
+  Parser instance(source, options.validateUTF8);
+  instance.m_maxDepth = options.maxDepth;
+  NoParseStats stats;
+  return instance.ParseRoot(stats);
+}
+
+/**
+ * @brief Parses a complete value that sits inside `depth` containers of a larger document,
+ * such as an element of the root array split off by JSON::ParseParallel.
+ *
+ * The enclosing containers count towards `options.maxDepth`, so the value is accepted
+ * exactly when the whole document would be.
+ */
+JSONValue Parser::ParseNested(const std::string_view& source, const ParseOptions& options, const std::size_t depth)
+{
+  Parser instance(source, options.validateUTF8);
+  instance.m_maxDepth = options.maxDepth;
+  instance.m_depth = depth;
+  NoParseStats stats;
+  return instance.ParseRoot(stats);
+}
+
+/**
+ * @brief Parses JSON source text into an arena-backed JSONDocument.
+ *
+ * Any previous content of the document is released, but its memory is kept for reuse.
+ * The arena is sized from the input up front, so a parse needs only a handful of heap
+ * allocations regardless of how many values the document contains.
+ *
+ * @param source The JSON-encoded text to parse.
+ * @param document The document that receives the parsed nodes.
+ * @param options Settings for the parse, see ParseOptions.
+ * @throws std::runtime_error If the input is not valid JSON.
+ */
+void Parser::Parse(const std::string_view& source, JSONDocument& document, const ParseOptions& options)
+{
+  Parser instance(source, options.validateUTF8);
+  instance.ParseDocumentRoot(source, document, options);
+}
+
+/**
+ * @brief Parses into a JSONDocument using the scratch buffers of a long-lived JSONParser.
+ *
+ * The buffers are lent to the parse and handed back afterwards, also when it throws,
+ * so their capacity carries over to the next parse.
+ */
+void Parser::Parse(const std::string_view& source, JSONDocument& document, const ParseOptions& options, JSONParser& buffers)
+{
+  Parser instance(source, options.validateUTF8);
+  instance.SwapBuffers(buffers);
+  try
+  {
+    instance.ParseDocumentRoot(source, document, options);
+  }
+  catch (...)
+  {
+    instance.SwapBuffers(buffers);
+    throw;
+  }
+  instance.SwapBuffers(buffers);
+}
+
+void Parser::ParseDocumentRoot(const std::string_view& source, JSONDocument& document, const ParseOptions& options)
+{
+  document.Reset();
+  document.m_arena.Reserve(source.size() * 2 + 4096);
+
+  m_document = &document;
+  m_options = options;
+  m_maxDepth = options.maxDepth;
+  document.m_sharedKeys = options.keyTable;
+  m_keys = options.keyTable != nullptr ? options.keyTable : &document.m_keys;
+
+  if (Peek().type == TokenType::END_OF_FILE) return;
+
+  document.m_root = ParseNode();
+
+  if (Peek().type != TokenType::END_OF_FILE)
+  {
+    throw std::runtime_error("Unexpected data after end of JSON");
+  }
+}
+
+void Parser::SwapBuffers(JSONParser& buffers)
+{
+  // A parse that threw leaves its partial results on the stacks.
+  buffers.m_frameStack.clear();
+  buffers.m_nodeStack.clear();
+  buffers.m_memberStack.clear();
+  m_frameStack.swap(buffers.m_frameStack);
+  m_nodeStack.swap(buffers.m_nodeStack);
+  m_memberStack.swap(buffers.m_memberStack);
+  m_scratch.swap(buffers.m_scratch);
+}
+
+/**
+ * @brief Parses JSON source text onto a JSONTape.
+ *
+ * Any previous content of the tape is discarded, but its capacity is kept. The worst case,
+ * one word per byte of the source and two string bytes per byte of a string token, would
+ * reserve about ten times the source; typical documents need one to three times. So both
+ * buffers start out at a guess of one word per four source bytes and half a string byte
+ * per source byte, and grow geometrically past it. The parse refers to what it has written
+ * by index only, so nothing breaks when the buffers move.
+ *
+ * @param source The JSON-encoded text to parse.
+ * @param tape The tape that receives the parsed values.
+ * @param options Settings for the parse. Only `options.maxDepth` and `options.validateUTF8` apply to a tape.
+ * @throws std::runtime_error If the input is not valid JSON, nests too deeply or is too large to index with 32 bits.
+ */
+void Parser::Parse(const std::string_view& source, JSONTape& tape, const ParseOptions& options)
+{
+  if (source.size() >= UINT32_MAX - 2) throw std::runtime_error("JSON document too large for a tape");
+
+  tape.m_words.clear();
+  tape.m_strings.clear();
+  tape.m_words.reserve(source.size() / 4 + 2);
+  tape.m_strings.reserve(source.size() / 2);
+
+  Parser instance(source, options.validateUTF8);
+  instance.m_tape = &tape;
+  instance.m_maxDepth = options.maxDepth;
+
+  if (instance.Peek().type == TokenType::END_OF_FILE) return;
+
+  instance.ParseTapeValue();
 
   if (instance.Peek().type != TokenType::END_OF_FILE)
   {
     throw std::runtime_error("Unexpected data after end of JSON");
   }
+}
+
+/**
+ * @brief Parses the first JSON value in the source and ignores whatever follows it.
+ *
+ * Used to materialise a single value out of a larger document, e.g. by JSONCursor.
+ *
+ * @param source Text starting with a JSON value.
+ * @param options Settings for the parse. Only `options.maxDepth` and `options.validateUTF8` apply.
+ * @return A JSONValue object representing the first value.
+ * @throws std::runtime_error If the value is not valid JSON.
+ */
+JSONValue Parser::ParsePrefix(const std::string_view& source, const ParseOptions& options)
+{
+  Parser instance(source, options.validateUTF8);
+  instance.m_maxDepth = options.maxDepth;
+  NoParseStats stats;
+  return instance.ParseValue(stats);
+}
+
+/**
+ * @brief Parses a complete document and checks that nothing follows it.
+ */
+template <typename Stats>
+JSONValue Parser::ParseRoot(Stats& stats)
+{
+  if (Peek().type == TokenType::END_OF_FILE)
+  {
+    return {JSONValue()};
+  }
+
+  JSONValue value = ParseValue(stats);
+
+  if (Peek().type != TokenType::END_OF_FILE)
+  {
+    throw std::runtime_error("Unexpected data after end of JSON");
+  }
 
   return value;
 }
 
 /**
- * @brief Parses the next token in the sequence into a JSONValue.
+ * @brief Parses the next value, and everything nested inside it, into a JSONValue.
  *
- * This method examines the current token in the input stream and determines
- * its type to construct the appropriate JSONValue. It handles various JSON
- * value types, including objects, arrays, strings, integers, doubles, booleans,
- * and null values. Unexpected token types result in an exception.
+ * The parse does not recurse. Containers that are still open wait on an explicit stack of
+ * frames, so how deeply the input may nest is set by m_maxDepth rather than by the size of
+ * the call stack. Every pass of the loop reads one value: a scalar is complete at once, while
+ * a container gets a frame and is completed once its closing token has been read. A completed
+ * value is added to the container on top of the stack, and every container that closes right
+ * after it is completed and added to its own parent in turn.
  *
- * @return A JSONValue object representing the parsed value. The type of the
- *         JSONValue depends on the token being processed:
+ * Values are created from tokens as follows:
  *         - JSON object for LEFT_BRACE tokens
  *         - JSON array for LEFT_BRACKET tokens
  *         - String for STRING tokens
- *         - Integer for INT tokens
+ *         - Integer (int64_t, or uint64_t if it is larger) for INT tokens
  *         - Double for DOUBLE tokens
  *         - Boolean for TRUE and FALSE tokens
  *         - Null for NULL_TYPE tokens
- * @throws std::runtime_error If the token type is unknown or unexpected.
+ *
+ * @return The parsed value.
+ * @throws std::runtime_error If the input is not valid JSON or nests deeper than the maximum depth.
  */
-JSONValue Parser::ParseValue()
+template <typename Stats>
+JSONValue Parser::ParseValue(Stats& stats)
 {
-  Token token = Peek();
+  std::vector<ValueFrame> stack;
 
-  switch (token.type)
+  while (true)
   {
-  case TokenType::LEFT_BRACE:
+    const Token token = Peek();
+    JSONValue value;
+
+    switch (token.type)
     {
-      return ParseObject();
+    case TokenType::LEFT_BRACE:
+    case TokenType::LEFT_BRACKET:
+      {
+        if (m_depth + stack.size() >= m_maxDepth) throw DepthError(m_maxDepth);
+        if (stack.empty()) stack.reserve(std::min<std::size_t>(m_maxDepth, InitialStackDepth));
+
+        Advance(stats); // Eat beginning brace or bracket
+        stats.Enter();
+        stack.emplace_back();
+        stack.back().isObject = token.type == TokenType::LEFT_BRACE;
+        if (!NextChild(stack.back(), true, stats)) continue; // Go on with the first child
+
+        // Empty container
+        value = TakeFrame(stack.back());
+        stack.pop_back();
+        stats.Leave();
+        break;
+      }
+
+    case TokenType::STRING:
+      {
+        Advance(stats);
+        value = JSONValue{ParseString(token, stats)};
+        break;
+      }
+
+    case TokenType::INT:
+    case TokenType::DOUBLE:
+      {
+        Advance(stats);
+        const typename Stats::Timer timer(stats, &ParseStats::numberNanoseconds);
+        value = ParseNumberValue(token);
+        break;
+      }
+
+    case TokenType::TRUE:
+    case TokenType::FALSE:
+      {
+        Advance(stats);
+        value = JSONValue{token.type == TokenType::TRUE};
+        break;
+      }
+
+    case TokenType::NULL_TYPE:
+      {
+        Advance(stats);
+        break; // std::monostate
+      }
+
+    default:
+      {
+        throw std::runtime_error("Unexpected token type" + std::string(token.value));
+      }
     }
 
-  case TokenType::LEFT_BRACKET:
+    // Add the finished value to its container, then close every container that ends here.
+    while (true)
     {
-      return ParseArray();
+      if (stack.empty()) return value;
+
+      ValueFrame& frame = stack.back();
+      AddToFrame(frame, std::move(value), stats);
+      if (!NextChild(frame, false, stats)) break; // Go on with the next child
+
+      value = TakeFrame(frame);
+      stack.pop_back();
+      stats.Leave();
     }
+  }
+}
+
+/**
+ * @brief Reads the comma after a container's previous child, unless `first` is set, and checks
+ * whether the container ends here. Otherwise, for an object, reads the key of the next member.
+ *
+ * As before the parse became iterative, a comma directly before the closing token is accepted.
+ *
+ * @return True if the container's closing token was read.
+ * @throws std::runtime_error If a separator, key or colon is missing.
+ */
+template <typename Stats>
+bool Parser::NextChild(ValueFrame& frame, const bool first, Stats& stats)
+{
+  const TokenType close = frame.isObject ? TokenType::RIGHT_BRACE : TokenType::RIGHT_BRACKET;
+
+  if (!first && Peek().type != close)
+  {
+    Expect(TokenType::COMMA);
+    Advance(stats);
+  }
+
+  if (Peek().type == close)
+  {
+    Advance(stats); // Eat the ending brace or bracket
+    return true;
+  }
+
+  if (frame.isObject)
+  {
+    Expect(TokenType::STRING);
+    frame.key = ParseString(Peek(), stats);
+    Advance(stats);
+
+    Expect(TokenType::COLON);
+    Advance(stats);
+  }
+  return false;
+}
+
+/**
+ * @brief Appends a finished child to an open container. A repeated key replaces the earlier value.
+ */
+template <typename Stats>
+void Parser::AddToFrame(ValueFrame& frame, JSONValue&& value, Stats& stats)
+{
+  if (frame.isObject)
+  {
+    const std::size_t capacity = frame.object.capacity();
+    frame.object[std::move(frame.key)] = std::move(value);
+    if (frame.object.capacity() != capacity) stats.Allocated(frame.object.capacity() * sizeof(JSONObject::value_type));
+    return;
+  }
+
+  const std::size_t capacity = frame.array.capacity();
+  frame.array.push_back(std::move(value));
+  if (frame.array.capacity() != capacity) stats.Allocated(frame.array.capacity() * sizeof(JSONValue));
+}
+
+/**
+ * @brief Moves the finished container out of its frame.
+ */
+JSONValue Parser::TakeFrame(ValueFrame& frame)
+{
+  if (frame.isObject) return JSONValue{std::move(frame.object)};
+  return JSONValue{std::move(frame.array)};
+}
+
+/**
+ * @brief The error thrown when the input nests deeper than `maxDepth` containers.
+ */
+std::runtime_error Parser::DepthError(const std::size_t maxDepth)
+{
+  return std::runtime_error("JSON nesting exceeds the maximum depth of " + std::to_string(maxDepth));
+}
+
+/**
+ * @brief Counts one more level of nesting for the document and tape parses.
+ * @throws std::runtime_error If that exceeds the maximum depth.
+ */
+void Parser::Descend()
+{
+  if (++m_depth > m_maxDepth) throw DepthError(m_maxDepth);
+}
+
+/**
+ * @brief Converts a string token into an owned string, decoding escape sequences if it has any.
+ */
+template <typename Stats>
+std::string Parser::ParseString(const Token& token, Stats& stats)
+{
+  const typename Stats::Timer timer(stats, &ParseStats::stringNanoseconds);
+  std::string value;
+
+  if (!token.escaped) value = token.value;
+  else
+  {
+    value.resize(token.value.size()); // Reserves memory for the worst case scenario.
+    value.resize(Unescape(token.value, value.data()));
+    stats.Unescaped(token.value.size());
+  }
+
+  // Short strings are stored inline and need no allocation.
+  if (value.capacity() > std::string().capacity()) stats.Allocated(value.capacity() + 1);
+  return value;
+}
+
+/**
+ * @brief Decodes the escape sequences of a raw string token.
+ *
+ * The text between escapes is found with a vectorized search and copied in bulk.
+ * `\uXXXX` escapes are decoded in place to UTF-8, combining a high and a low surrogate
+ * escape into one four-byte code point. A surrogate without its partner becomes U+FFFD.
+ *
+ * The decoded string is never longer than the raw one, so `out` must provide
+ * room for `str.size()` characters.
+ *
+ * @param str The raw contents of a string token, without the surrounding quotes.
+ * @param out The buffer that receives the decoded characters.
+ * @return The number of characters written to `out`.
+ * @throws std::runtime_error If a `\u` escape is not followed by four hex digits.
+ */
+std::size_t Parser::Unescape(const std::string_view& str, char* out)
+{
+  const char* data = str.data();
+  const std::size_t size = str.size();
+  std::size_t length = 0;
+  std::size_t i = 0;
 
-  case TokenType::STRING:
+  while (i < size)
+  {
+    const std::size_t run = StringScanner::FindBackslash(data + i, size - i);
+    std::memcpy(out + length, data + i, run);
+    length += run;
+    i += run;
+
+    if (i + 1 >= size)
     {
-      Next();
-      std::string value = ParseString(token.value);
-      return JSONValue(value);
+      // A trailing lone backslash is kept as is.
+      if (i < size) out[length++] = data[i++];
+      break;
     }
 
-  case TokenType::DOUBLE:
+    switch (data[i + 1]) // We check the char after the '\'
     {
-      Next();
-      double value = std::stod(std::string(token.value));
-      return JSONValue(value);
+      case '"': out[length++] = '"'; break;
+      case '\\': out[length++] = '\\'; break;
+      case '/': out[length++] = '/'; break;
+      case 'b': out[length++] = '\b'; break;
+      case 'f': out[length++] = '\f'; break;
+      case 'n': out[length++] = '\n'; break;
+      case 'r': out[length++] = '\r'; break;
+      case 't': out[length++] = '\t'; break;
+      case 'u':
+        {
+          uint32_t codePoint = DecodeHex(str, i + 2);
+          i += 4;
+
+          if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+          {
+            // A high surrogate must be followed by a low surrogate escape.
+            uint32_t low = 0;
+            if (i + 7 < size && data[i + 2] == '\\' && data[i + 3] == 'u') low = DecodeHex(str, i + 4);
+
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+              codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+              i += 6;
+            }
+            else codePoint = 0xFFFD;
+          }
+          else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) codePoint = 0xFFFD;
+
+          length += EncodeUTF8(codePoint, out + length);
+          break;
+        }
+      default: out[length++] = data[i + 1];
     }
+    i += 2; // Eat the backslash and the char after it
+  }
+  return length;
+}
+
+/**
+ * @brief Reads the four hex digits of a `\u` escape starting at `offset`.
+ * @throws std::runtime_error If there are fewer than four characters left or one is not a hex digit.
+ */
+uint32_t Parser::DecodeHex(const std::string_view& str, const std::size_t offset)
+{
+  if (offset + 4 > str.size()) throw std::runtime_error("Incomplete unicode escape in string");
+
+  uint32_t value = 0;
+  for (std::size_t i = offset; i < offset + 4; i++)
+  {
+    const char c = str[i];
+    uint32_t digit;
+    if (c >= '0' && c <= '9') digit = c - '0';
+    else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+    else throw std::runtime_error("Invalid unicode escape in string");
+    value = (value << 4) | digit;
+  }
+  return value;
+}
+
+/**
+ * @brief Writes a Unicode code point as UTF-8.
+ * @return The number of bytes written, between one and four.
+ */
+std::size_t Parser::EncodeUTF8(const uint32_t codePoint, char* out)
+{
+  // 1-Byte range
+  if (codePoint <= 0x7F)
+  {
+    out[0] = static_cast<char>(codePoint);
+    return 1;
+  }
+
+  // 2-Byte range
+  if (codePoint <= 0x7FF)
+  {
+    out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+    out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 2;
+  }
+
+  // 3-Byte range
+  if (codePoint <= 0xFFFF)
+  {
+    out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+    out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 3;
+  }
 
-  case TokenType::TRUE:
+  // 4-Byte range, only reachable through a surrogate pair
+  out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+  out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+  return 4;
+}
+
+/**
+ * @brief Converts a number token without allocating, independent of the current locale.
+ *
+ * INT tokens are read as int64_t, or as uint64_t when they are positive and larger than
+ * INT64_MAX, so integers keep their full precision. Integers that do not fit either type,
+ * and all DOUBLE tokens, go through std::from_chars, which rounds correctly.
+ *
+ * @param token An INT or DOUBLE token.
+ * @return The number in the narrowest exact type.
+ * @throws std::runtime_error If the token is not a valid number or is out of range for a double.
+ */
+ParsedNumber Parser::ParseNumber(const Token& token)
+{
+  const char* first = token.value.data();
+  const char* last = first + token.value.size();
+  ParsedNumber result{};
+
+  if (token.type == TokenType::INT)
+  {
+    std::from_chars_result parsed{};
+    if (first != last && *first == '-')
     {
-      Next();
-      return JSONValue(true);
+      parsed = std::from_chars(first, last, result.integer);
+      result.type = JSONType::Int64;
     }
-
-  case TokenType::FALSE:
+    else
     {
-      Next();
-      return JSONValue(false);
+      parsed = std::from_chars(first, last, result.unsignedInteger);
+      result.type = result.unsignedInteger > static_cast<uint64_t>(INT64_MAX) ? JSONType::UInt64 : JSONType::Int64;
     }
-  case TokenType::NULL_TYPE:
+
+    if (parsed.ec == std::errc() && parsed.ptr == last) return result;
+    if (parsed.ec != std::errc::result_out_of_range) throw std::runtime_error("Invalid number: " + std::string(token.value));
+    // Too large for 64 bits, so it can only be represented approximately.
+  }
+
+  const auto [ptr, ec] = std::from_chars(first, last, result.number);
+  if (ec == std::errc::result_out_of_range) throw std::runtime_error("Number out of range: " + std::string(token.value));
+  if (ec != std::errc() || ptr != last) throw std::runtime_error("Invalid number: " + std::string(token.value));
+  result.type = JSONType::Double;
+  return result;
+}
+
+/**
+ * @brief Converts a number token into a JSONValue holding an int64_t, uint64_t or double.
+ */
+JSONValue Parser::ParseNumberValue(const Token& token)
+{
+  const ParsedNumber number = ParseNumber(token);
+  switch (number.type)
+  {
+    case JSONType::Int64: return JSONValue{number.integer};
+    case JSONType::UInt64: return JSONValue{number.unsignedInteger};
+    default: return JSONValue{number.number};
+  }
+}
+
+/**
+ * @brief Parses the next value, and everything nested inside it, into a JSONNode, placing the
+ * contents of its containers in the document's arena.
+ *
+ * Mirrors ParseValue(), and does not recurse either. Open containers wait on m_frameStack and
+ * their finished children on m_nodeStack or m_memberStack. Once a container closes, its children
+ * are copied into the arena as one contiguous block.
+ *
+ * Members are stored in document order, and a repeated key is stored once per occurrence
+ * rather than replacing the earlier value as in the JSONValue parse. JSONNode lookups return
+ * the last match, so they agree with the JSONValue parse all the same.
+ *
+ * @return The parsed node.
+ * @throws std::runtime_error If the input is not valid JSON or nests deeper than the maximum depth.
+ */
+JSONNode Parser::ParseNode()
+{
+  while (true)
+  {
+    const Token token = Peek();
+    JSONNode node;
+
+    switch (token.type)
     {
-      Next();
-      return {}; // std::monostate
+    case TokenType::LEFT_BRACE:
+    case TokenType::LEFT_BRACKET:
+      {
+        Descend();
+        Next(); // Eat beginning brace or bracket
+        const bool isObject = token.type == TokenType::LEFT_BRACE;
+        m_frameStack.push_back({isObject ? m_memberStack.size() : m_nodeStack.size(), {}, isObject});
+        if (!NextNodeChild(true)) continue; // Go on with the first child
+
+        node = CloseNode(); // Empty container
+        break;
+      }
+
+    case TokenType::STRING:
+      {
+        Next();
+        const std::string_view value = ParseNodeString(token);
+        node.type = JSONType::String;
+        node.string = value.data();
+        node.size = static_cast<uint32_t>(value.size());
+        break;
+      }
+
+    case TokenType::INT:
+    case TokenType::DOUBLE:
+      {
+        Next();
+        const ParsedNumber number = ParseNumber(token);
+        node.type = number.type;
+        if (number.type == JSONType::Double) node.number = number.number;
+        else node.integer = number.integer; // Same bits for both integer types
+        break;
+      }
+
+    case TokenType::TRUE:
+    case TokenType::FALSE:
+      {
+        Next();
+        node.type = JSONType::Bool;
+        node.boolean = token.type == TokenType::TRUE;
+        break;
+      }
+
+    case TokenType::NULL_TYPE:
+      {
+        Next();
+        break;
+      }
+
+    default:
+      {
+        throw std::runtime_error("Unexpected token type" + std::string(token.value));
+      }
     }
 
-  default:
+    // Add the finished node to its container, then close every container that ends here.
+    while (true)
     {
-      throw std::runtime_error("Unexpected token type" + std::string(token.value));
+      if (m_frameStack.empty()) return node;
+
+      const JSONParser::NodeFrame& frame = m_frameStack.back();
+      if (frame.isObject) m_memberStack.push_back(JSONMember{frame.key, node});
+      else m_nodeStack.push_back(node);
+      if (!NextNodeChild(false)) break; // Go on with the next child
+
+      node = CloseNode();
     }
   }
 }
 
 /**
- * @brief Parses a JSON object from the current sequence of tokens.
- *
- * This method extracts a JSON object structure from the token stream, ensuring that
- * all required syntax rules are followed. It assumes that the token at the current
- * position is a left brace ({) and processes until a matching right brace (}) is found.
- * Within the object, key-value pairs are parsed, where each key is expected to be a
- * string followed by a colon (:), and each value can be any valid JSON type. Keys are
- * unique within the object, and pairs are separated by commas (,).
+ * @brief The document parse's NextChild(): reads the comma after the innermost open container's
+ * previous child, unless `first` is set, and checks whether the container ends here. Otherwise,
+ * for an object, reads and interns the key of the next member.
  *
- * @return A JSONValue object representing the parsed JSON object, where the keys are
- *         mapped to their corresponding JSON values.
- * @throws std::runtime_error If the input tokens do not match the expected JSON object format
- *                            or if unexpected tokens are encountered.
+ * @return True if the container's closing token was read.
+ * @throws std::runtime_error If a separator, key or colon is missing.
  */
-JSONValue Parser::ParseObject()
+bool Parser::NextNodeChild(const bool first)
 {
-  Expect(TokenType::LEFT_BRACE);
-  Next(); // Eat beginning brace
+  JSONParser::NodeFrame& frame = m_frameStack.back();
+  const TokenType close = frame.isObject ? TokenType::RIGHT_BRACE : TokenType::RIGHT_BRACKET;
 
-  std::map<std::string, JSONValue> value;
+  if (!first && Peek().type != close)
+  {
+    Expect(TokenType::COMMA);
+    Next();
+  }
 
-  while (Peek().type != TokenType::RIGHT_BRACE)
+  if (Peek().type == close)
+  {
+    Next(); // Eat the ending brace or bracket
+    return true;
+  }
+
+  if (frame.isObject)
   {
     Expect(TokenType::STRING);
-    std::string key = std::string(Peek().value);
+    frame.key = ParseNodeKey(Peek());
     Next();
 
     Expect(TokenType::COLON);
     Next();
+  }
+  return false;
+}
+
+/**
+ * @brief Closes the innermost open container, moving its children from the node or member
+ * stack into the arena.
+ *
+ * @return A JSONNode of type Array or Object.
+ */
+JSONNode Parser::CloseNode()
+{
+  const JSONParser::NodeFrame frame = m_frameStack.back();
+  m_frameStack.pop_back();
+  m_depth--;
 
-    value[key] = ParseValue();
+  JSONNode node;
+  if (frame.isObject)
+  {
+    node.type = JSONType::Object;
+    node.size = static_cast<uint32_t>(m_memberStack.size() - frame.base);
+    node.members = nullptr;
 
-    if (Peek().type != TokenType::RIGHT_BRACE)
+    if (node.size != 0)
     {
-      Expect(TokenType::COMMA);
-      Next();
+      auto* members = m_document->m_arena.Allocate<JSONMember>(node.size);
+      std::copy(m_memberStack.begin() + static_cast<std::ptrdiff_t>(frame.base), m_memberStack.end(), members);
+      node.members = members;
     }
+    m_memberStack.resize(frame.base);
+    return node;
   }
 
-  Expect(TokenType::RIGHT_BRACE);
-  Next(); // Eat the ending brace
-  return JSONValue{value};
+  node.type = JSONType::Array;
+  node.size = static_cast<uint32_t>(m_nodeStack.size() - frame.base);
+  node.elements = nullptr;
+
+  if (node.size != 0)
+  {
+    auto* elements = m_document->m_arena.Allocate<JSONNode>(node.size);
+    std::copy(m_nodeStack.begin() + static_cast<std::ptrdiff_t>(frame.base), m_nodeStack.end(), elements);
+    node.elements = elements;
+  }
+  m_nodeStack.resize(frame.base);
+  return node;
 }
 
 /**
- * @brief Parses a JSON array from the current token sequence.
+ * @brief Decodes a string token into the document's arena.
  *
- * This method processes a sequence of tokens that represent a JSON array,
- * including handling nested arrays and validating the syntax. It expects the
- * current token to be the beginning of an array ('[') and iteratively parses
- * each array element until the closing bracket (']') is reached.
- *
- * @return A JSONValue object containing a vector of JSONValue elements
- *         representing the parsed array.
- * @throws std::runtime_error If the syntax is invalid, such as a missing
- *         closing bracket, or if any array element is improperly formatted.
+ * With ParseOptions::zeroCopyStrings, strings without escape sequences are returned
+ * as views into the source and never copied.
  */
-JSONValue Parser::ParseArray()
+std::string_view Parser::ParseNodeString(const Token& token)
 {
-  Expect(TokenType::LEFT_BRACKET);
-  Next(); // Eat beginning bracket
-
-  std::vector<JSONValue> value;
+  const std::string_view str = token.value;
+  if (str.empty()) return {};
+  if (!token.escaped && m_options.zeroCopyStrings) return str;
 
-  while (Peek().type != TokenType::RIGHT_BRACKET)
+  char* out = m_document->m_arena.Allocate<char>(str.size());
+  if (!token.escaped)
   {
-    value.push_back(ParseValue());
-
-    if (Peek().type != TokenType::RIGHT_BRACKET)
-    {
-      Expect(TokenType::COMMA);
-      Next();
-    }
+    std::memcpy(out, str.data(), str.size());
+    return {out, str.size()};
   }
+  return {out, Unescape(str, out)};
+}
 
-  Expect(TokenType::RIGHT_BRACKET);
-  Next(); // Eat ending bracket
-  return JSONValue{value};
+/**
+ * @brief Decodes an object key and interns it, so every distinct key is stored once.
+ */
+std::string_view Parser::ParseNodeKey(const Token& token)
+{
+  if (!token.escaped) return m_keys->Intern(token.value).name;
 
+  m_scratch.resize(token.value.size());
+  m_scratch.resize(Unescape(token.value, m_scratch.data()));
+  return m_keys->Intern(m_scratch).name;
 }
 
-std::string Parser::ParseString(const std::string_view& str)
+/**
+ * @brief Appends the next value, and everything nested inside it, to the tape.
+ *
+ * Mirrors ParseNode(), but writes the tape representation described in JSONTapeDetail, and
+ * needs no stack of its own: until a container closes, its opening word holds the number of
+ * children so far in bits 32-55 and the index of the enclosing container's opening word in
+ * bits 0-31, so the open containers form a list through the tape itself.
+ *
+ * @throws std::runtime_error If the input is not valid JSON or nests deeper than the maximum depth.
+ */
+void Parser::ParseTapeValue()
 {
-  std::string value;
-  value.reserve(str.size()); // Reserves memory for the worst case scenario.
+  using namespace JSONTapeDetail;
+  std::vector<uint64_t>& words = m_tape->m_words;
+  std::size_t open = NoTapeContainer; // Index of the innermost open container's opening word
 
-  for (unsigned int i = 0; i < str.length(); i++)
+  while (true)
   {
-    if (str[i] == '\\' && i + 1 < str.length())
+    const Token token = Peek();
+
+    switch (token.type)
     {
-      switch (str[i + 1]) // We check the char after the '\'
+    case TokenType::LEFT_BRACE:
+    case TokenType::LEFT_BRACKET:
+      {
+        Descend();
+        Next(); // Eat the opening brace or bracket
+        const std::size_t start = words.size();
+        words.push_back(MakeWord(token.type == TokenType::LEFT_BRACE ? Object : Array, open));
+        open = start;
+        if (!NextTapeChild(open, true)) continue; // Go on with the first child
+
+        open = CloseTapeContainer(open); // Empty container
+        break;
+      }
+
+    case TokenType::STRING:
+      {
+        Next();
+        AppendTapeString(token);
+        break;
+      }
+
+    case TokenType::INT:
+    case TokenType::DOUBLE:
       {
-        case '"': value += '"'; break;
-        case '\\': value += '\\'; break;
-        case '/': value += '/'; break;
-        case 'b': value += '\b'; break;
-        case 'f': value += '\f'; break;
-        case 'n': value += '\n'; break;
-        case 'r': value += '\r'; break;
-        case 't': value += '\t'; break;
-        case 'u': value += HexToString(std::string(str.substr(i+2, 4))); i += 4; break;
-        default: value += str[i + 1];
+        Next();
+        const ParsedNumber number = ParseNumber(token);
+        if (number.type == JSONType::Double)
+        {
+          words.push_back(MakeWord(Double, 0));
+          words.push_back(std::bit_cast<uint64_t>(number.number));
+        }
+        else
+        {
+          words.push_back(MakeWord(number.type == JSONType::Int64 ? Int64 : UInt64, 0));
+          words.push_back(number.unsignedInteger); // Same bits for both integer types
+        }
+        break;
+      }
+
+    case TokenType::TRUE:
+    case TokenType::FALSE:
+      {
+        Next();
+        words.push_back(MakeWord(Bool, token.type == TokenType::TRUE));
+        break;
+      }
+
+    case TokenType::NULL_TYPE:
+      {
+        Next();
+        words.push_back(MakeWord(Null, 0));
+        break;
+      }
+
+    default:
+      {
+        throw std::runtime_error("Unexpected token type" + std::string(token.value));
       }
-      i++; // Eat the char
     }
-    else
+
+    // Count the finished value in its container, then close every container that ends here.
+    while (true)
     {
-      value += str[i];
+      if (open == NoTapeContainer) return;
+
+      if ((words[open] >> 32 & MaxCount) < MaxCount) words[open] += uint64_t{1} << 32;
+      if (!NextTapeChild(open, false)) break; // Go on with the next child
+
+      open = CloseTapeContainer(open);
     }
   }
-  return value;
 }
 
 /**
- * @brief Converts a hexadecimal string to its UTF-8 encoded representation.
+ * @brief The tape parse's NextChild(): reads the comma after the previous child of the container
+ * opened at `start`, unless `first` is set, and checks whether the container ends here.
+ * Otherwise, for an object, appends the key of the next member.
  *
- * This method interprets a hexadecimal string as a Unicode code point and encodes it
- * as a UTF-8 string.
- *
- * @param hex A string representing a Unicode code point in hexadecimal format.
- * @return A string containing the UTF-8 encoded character corresponding to the input hexadecimal value.
+ * @return True if the container's closing token was read.
+ * @throws std::runtime_error If a separator, key or colon is missing.
  */
-std::string Parser::HexToString(const std::string& hex)
+bool Parser::NextTapeChild(const std::size_t start, const bool first)
 {
-  std::string value;
-  const int hexValue = std::stoi(std::string(hex), nullptr, 16);
+  const bool object = JSONTapeDetail::TagOf(m_tape->m_words[start]) == JSONTapeDetail::Object;
+  const TokenType close = object ? TokenType::RIGHT_BRACE : TokenType::RIGHT_BRACKET;
 
-  // 1-Byte range
-  if (hexValue <= 0x7F)
+  if (!first && Peek().type != close)
   {
-    value += static_cast<char>(hexValue);
+    Expect(TokenType::COMMA);
+    Next();
   }
 
-  // 2-Byte range
-  else if (hexValue <= 0x7FF)
+  if (Peek().type == close)
   {
-    value += static_cast<char>(0xC0 | ((hexValue >> 6) & 0x1F));
-    value += static_cast<char>(0x80 | (hexValue & 0x3F));
+    Next(); // Eat the closing brace or bracket
+    return true;
   }
 
-  // 3-Byte range
-  else if (hexValue <= 0xFFFF)
+  if (object)
   {
-    value += static_cast<char>(0xE0 | ((hexValue >> 12) & 0x0F));
-    value += static_cast<char>(0x80 | ((hexValue >> 6) & 0x3F));
-    value += static_cast<char>(0x80 | (hexValue & 0x3F));
+    Expect(TokenType::STRING);
+    AppendTapeString(Peek());
+    Next();
+
+    Expect(TokenType::COLON);
+    Next();
   }
+  return false;
+}
 
-  return value;
+/**
+ * @brief Appends the closing word of the container opened at `start`, and fills in its opening
+ * word with the child count and the link past the container.
+ *
+ * @return The index of the enclosing container's opening word, or NoTapeContainer.
+ */
+std::size_t Parser::CloseTapeContainer(const std::size_t start)
+{
+  using namespace JSONTapeDetail;
+  std::vector<uint64_t>& words = m_tape->m_words;
+
+  const uint64_t open = words[start];
+  const bool object = TagOf(open) == Object;
+  const std::size_t parent = open & 0xFFFFFFFF;
+
+  words.push_back(MakeWord(object ? ObjectEnd : ArrayEnd, start));
+  words[start] = MakeWord(object ? Object : Array, (open >> 32 & MaxCount) << 32 | words.size());
+  m_depth--;
+  return parent;
+}
+
+/**
+ * @brief Appends a string's length and decoded bytes to the string buffer, and its word to the tape.
+ */
+void Parser::AppendTapeString(const Token& token)
+{
+  std::vector<char>& strings = m_tape->m_strings;
+  const std::size_t offset = strings.size();
+
+  strings.resize(offset + sizeof(uint32_t) + token.value.size());
+  char* out = strings.data() + offset + sizeof(uint32_t);
+  uint32_t length = static_cast<uint32_t>(token.value.size());
+  if (token.escaped) length = static_cast<uint32_t>(Unescape(token.value, out));
+  else std::memcpy(out, token.value.data(), length);
+
+  std::memcpy(strings.data() + offset, &length, sizeof(length));
+  strings.resize(offset + sizeof(uint32_t) + length);
+  m_tape->m_words.push_back(JSONTapeDetail::MakeWord(JSONTapeDetail::String, offset));
+}
+
+/**
+ * @brief Advances to the next token, reporting the token and the time spent lexing it to `stats`.
+ */
+template <typename Stats>
+void Parser::Advance(Stats& stats)
+{
+  {
+    const typename Stats::Timer timer(stats, &ParseStats::lexNanoseconds);
+    Next();
+  }
+  stats.Count(m_current);
 }
 
 /**
@@ -267,19 +1076,34 @@ std::string Parser::HexToString(const std::string& hex)
  * by the parser's index. It does not modify the state of the parser or move its position.
  *
  * @return The current Token object at the parser's position.
- * @throws std::out_of_range If the index is out of bounds of the token vector.
  */
-Token Parser::Peek() const
+const Token& Parser::Peek() const
 {
-  return m_tokens.at(m_index);
+  return m_current;
 }
 
 /**
  * @brief Advances the parser to the next token.
+ *
+ * In streaming mode the next token is lexed on demand. In buffered mode the index
+ * stays on the trailing END_OF_FILE token once it has been reached.
  */
 void Parser::Next()
 {
-  m_index++;
+  if (m_tokens == nullptr)
+  {
+    m_current = m_lexer.NextToken();
+    return;
+  }
+
+  if (m_index + 1 < m_tokens->size())
+  {
+    m_current = (*m_tokens)[++m_index];
+  }
+  else
+  {
+    m_current = Token{TokenType::END_OF_FILE, ""};
+  }
 }
 
 /**
@@ -295,7 +1119,7 @@ void Parser::Next()
  */
 void Parser::Expect(const TokenType type) const
 {
-  if (m_tokens.at(m_index).type != type)
+  if (m_current.type != type)
   {
     throw std::runtime_error("Unexpected token type");
   }
@@ -4,7 +4,89 @@
 
 #pragma once
 #include "../include/JSON.h"
-#include "../source/Token.h"
+#include "../include/JSONParser.h"
+#include "../include/JSONTokenizer.h"
+#include "../source/Lexer.h"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @struct NoParseStats
+ * @brief The instrumentation policy of a plain parse. Every hook is empty, so it compiles away.
+ */
+struct NoParseStats
+{
+  struct Timer
+  {
+    Timer(NoParseStats&, uint64_t ParseStats::*) {}
+  };
+
+  void Count(const Token&) {}
+  void Enter() {}
+  void Leave() {}
+  void Unescaped(std::size_t) {}
+  void Allocated(std::size_t) {}
+};
+
+/**
+ * @struct CollectParseStats
+ * @brief The instrumentation policy that fills in a ParseStats.
+ */
+struct CollectParseStats
+{
+  /// Adds the time from its construction to its destruction to one of the stats' counters.
+  class Timer
+  {
+  public:
+    Timer(CollectParseStats& collector, uint64_t ParseStats::* counter)
+      : m_counter(collector.stats.*counter), m_start(std::chrono::steady_clock::now()) {}
+    ~Timer()
+    {
+      m_counter += static_cast<uint64_t>(std::chrono::nanoseconds(std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+  private:
+    uint64_t& m_counter;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  ParseStats& stats;
+  std::size_t depth = 0;
+
+  void Count(const Token& token)
+  {
+    switch (token.type)
+    {
+      case TokenType::LEFT_BRACE:    stats.objectBegins++; break;
+      case TokenType::RIGHT_BRACE:   stats.objectEnds++; break;
+      case TokenType::LEFT_BRACKET:  stats.arrayBegins++; break;
+      case TokenType::RIGHT_BRACKET: stats.arrayEnds++; break;
+      case TokenType::COLON:         stats.colons++; break;
+      case TokenType::COMMA:         stats.commas++; break;
+      case TokenType::STRING:        stats.strings++; break;
+      case TokenType::INT:           stats.integers++; break;
+      case TokenType::DOUBLE:        stats.doubles++; break;
+      case TokenType::TRUE:          stats.trues++; break;
+      case TokenType::FALSE:         stats.falses++; break;
+      case TokenType::NULL_TYPE:     stats.nulls++; break;
+      default: return; // End of file, or an invalid token the parser is about to reject
+    }
+    stats.tokens++;
+  }
+
+  void Enter() { stats.maxDepth = std::max(stats.maxDepth, ++depth); }
+  void Leave() { depth--; }
+  void Unescaped(const std::size_t bytes) { stats.unescapedBytes += bytes; }
+
+  void Allocated(const std::size_t bytes)
+  {
+    stats.allocations++;
+    stats.allocatedBytes += bytes;
+  }
+};
 
 /**
  * @class Parser
@@ -17,21 +99,97 @@ class Parser
 {
 public:
   static JSONValue Parse(const std::vector<Token>& Tokens);
+  static JSONValue Parse(const std::string_view& source);
+  static JSONValue Parse(const std::string_view& source, ParseStats& stats);
+  static JSONValue Parse(const std::string_view& source, const ParseOptions& options);
+  static JSONValue ParseNested(const std::string_view& source, const ParseOptions& options, std::size_t depth);
+  static void Parse(const std::string_view& source, JSONDocument& document, const ParseOptions& options = {});
+  static void Parse(const std::string_view& source, JSONDocument& document, const ParseOptions& options, JSONParser& buffers);
+  static void Parse(const std::string_view& source, JSONTape& tape, const ParseOptions& options = {});
+  static JSONValue ParsePrefix(const std::string_view& source, const ParseOptions& options = {});
+  static std::size_t Unescape(const std::string_view& str, char* out);
+  static ParsedNumber ParseNumber(const Token& token);
+  static JSONValue ParseNumberValue(const Token& token);
+  static std::runtime_error DepthError(std::size_t maxDepth);
 
 private:
-  Parser(const std::vector<Token>& tokens) : m_tokens(tokens), m_index(0) {}
+  explicit Parser(const std::vector<Token>& tokens);
+  explicit Parser(const std::string_view& source, bool validateUTF8 = true);
   ~Parser() = default;
 
-  std::vector<Token> m_tokens;
+  // Streaming mode pulls tokens from m_lexer on demand, buffered mode walks m_tokens.
+  // Either way, m_current holds the single token of lookahead.
+  Lexer m_lexer;
+  const std::vector<Token>* m_tokens;
   unsigned int m_index;
+  Token m_current;
+
+  // Containers currently open, checked against the limit from ParseOptions::maxDepth.
+  // The JSONValue parse counts the frames on its own stack on top of this.
+  std::size_t m_depth = 0;
+  std::size_t m_maxDepth = ParseOptions::DefaultMaxDepth;
+
+  // Document mode: finished children wait on these stacks until their container
+  // closes, then get copied into the arena as one contiguous block.
+  JSONDocument* m_document = nullptr;
+  ParseOptions m_options;
+  KeyTable* m_keys = nullptr;
+  std::string m_scratch;
+  std::vector<JSONParser::NodeFrame> m_frameStack;
+  std::vector<JSONNode> m_nodeStack;
+  std::vector<JSONMember> m_memberStack;
+
+  // Tape mode: values are appended to the tape in document order.
+  JSONTape* m_tape = nullptr;
+
+  template <typename Stats>
+  JSONValue ParseRoot(Stats& stats);
+  void ParseDocumentRoot(const std::string_view& source, JSONDocument& document, const ParseOptions& options);
+  void SwapBuffers(JSONParser& buffers);
+
+  /// A container of the JSONValue parse that has been opened but not yet closed.
+  struct ValueFrame
+  {
+    bool isObject = false;
+    std::vector<JSONValue> array;
+    JSONObject object;
+    std::string key; // Key of the object member being parsed
+  };
+
+  // Frames reserved up front by the JSONValue parse; deeper input grows the stack.
+  static constexpr std::size_t InitialStackDepth = 32;
+
+  // The JSONValue parse is instrumented through a NoParseStats or CollectParseStats policy.
+  template <typename Stats>
+  JSONValue ParseValue(Stats& stats);
+  template <typename Stats>
+  bool NextChild(ValueFrame& frame, bool first, Stats& stats);
+  template <typename Stats>
+  void AddToFrame(ValueFrame& frame, JSONValue&& value, Stats& stats);
+  static JSONValue TakeFrame(ValueFrame& frame);
+  template <typename Stats>
+  std::string ParseString(const Token& token, Stats& stats);
+  static uint32_t DecodeHex(const std::string_view& str, std::size_t offset);
+  static std::size_t EncodeUTF8(uint32_t codePoint, char* out);
+
+  JSONNode ParseNode();
+  bool NextNodeChild(bool first);
+  JSONNode CloseNode();
+  std::string_view ParseNodeString(const Token& token);
+  std::string_view ParseNodeKey(const Token& token);
+
+  // Marks the end of the list of open containers on the tape.
+  static constexpr std::size_t NoTapeContainer = 0xFFFFFFFF;
 
-  JSONValue ParseValue();
-  JSONValue ParseObject();
-  JSONValue ParseArray();
-  std::string ParseString(const std::string_view& str);
-  static std::string HexToString(const std::string& hex);
+  void ParseTapeValue();
+  bool NextTapeChild(std::size_t start, bool first);
+  std::size_t CloseTapeContainer(std::size_t start);
+  void AppendTapeString(const Token& token);
 
-  [[nodiscard]] Token Peek() const;
+  [[nodiscard]] const Token& Peek() const;
   void Next();
+  template <typename Stats>
+  void Advance(Stats& stats);
   void Expect(TokenType type) const;
+  void Descend();
 };
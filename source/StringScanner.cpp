@@ -0,0 +1,528 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "StringScanner.h"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JSON_STRINGS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_TARGET(features) __attribute__((target(features)))
+#else
+#define JSON_TARGET(features)
+#endif
+
+/**
+ * Returns the fastest kernels the running CPU supports. The CPU is only queried once.
+ */
+const StringScanner::Kernels& StringScanner::Select()
+{
+  static const Kernels kernels = []() -> Kernels
+  {
+#if JSON_STRINGS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (osxsave && (_xgetbv(0) & 0x6) == 0x6)
+    {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) return {&FindBackslashAVX2, &FindEscapableAVX2, &ValidUTF8AVX2, "avx2"};
+    // SSE2 is part of the x86-64 baseline.
+    return {&FindBackslashSSE2, &FindEscapableSSE2, &ValidUTF8SSE2, "sse2"};
+#else
+    return {&FindBackslashScalar, &FindEscapableScalar, &ValidUTF8Scalar, "scalar"};
+#endif
+  }();
+
+  return kernels;
+}
+
+std::size_t StringScanner::FindBackslashScalar(const char* data, const std::size_t length)
+{
+  for (std::size_t i = 0; i < length; i++)
+  {
+    if (data[i] == '\\') return i;
+  }
+  return length;
+}
+
+std::size_t StringScanner::FindEscapableScalar(const char* data, const std::size_t length)
+{
+  for (std::size_t i = 0; i < length; i++)
+  {
+    const auto c = static_cast<unsigned char>(data[i]);
+    if (c == '"' || c == '\\' || c < 0x20) return i;
+  }
+  return length;
+}
+
+namespace
+{
+  /**
+   * Length of the well-formed multi-byte sequence starting at `bytes`, or 0 if there is none.
+   * Only the second byte has a range narrower than 0x80-0xBF, and only after four leads.
+   */
+  std::size_t SequenceLength(const unsigned char* bytes, const std::size_t remaining)
+  {
+    const unsigned char lead = bytes[0];
+    std::size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+
+    if (lead >= 0xC2 && lead <= 0xDF) length = 2;
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+      length = 3;
+      if (lead == 0xE0) low = 0xA0;       // Overlong
+      else if (lead == 0xED) high = 0x9F; // Surrogates
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+      length = 4;
+      if (lead == 0xF0) low = 0x90;       // Overlong
+      else if (lead == 0xF4) high = 0x8F; // Above U+10FFFF
+    }
+    else return 0; // Continuation byte, overlong two-byte lead or no lead at all
+
+    if (remaining < length || bytes[1] < low || bytes[1] > high) return 0;
+    for (std::size_t i = 2; i < length; i++)
+    {
+      if ((bytes[i] & 0xC0) != 0x80) return 0;
+    }
+    return length;
+  }
+}
+
+/**
+ * Skips ASCII eight bytes at a time and checks every other sequence byte by byte.
+ */
+bool StringScanner::ValidUTF8Scalar(const char* data, const std::size_t length)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+  std::size_t i = 0;
+  while (i < length)
+  {
+    if (i + 8 <= length)
+    {
+      uint64_t word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0)
+      {
+        i += 8;
+        continue;
+      }
+    }
+
+    if (bytes[i] < 0x80)
+    {
+      i++;
+      continue;
+    }
+
+    const std::size_t sequence = SequenceLength(bytes + i, length - i);
+    if (sequence == 0) return false;
+    i += sequence;
+  }
+  return true;
+}
+
+#if JSON_STRINGS_X86
+
+std::size_t StringScanner::FindBackslashSSE2(const char* data, const std::size_t length)
+{
+  const __m128i backslash = _mm_set1_epi8('\\');
+
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)));
+    if (mask != 0) return i + std::countr_zero(mask);
+  }
+  return i + FindBackslashScalar(data + i, length - i);
+}
+
+/**
+ * Bytes up to 0x1F are found as the bytes that max(byte, 0x1F) leaves unchanged at 0x1F.
+ */
+std::size_t StringScanner::FindEscapableSSE2(const char* data, const std::size_t length)
+{
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i matches = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+      _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+    if (mask != 0) return i + std::countr_zero(mask);
+  }
+  return i + FindEscapableScalar(data + i, length - i);
+}
+
+/**
+ * SSE2 has no byte shuffle for the table lookups of the AVX2 kernel, so this one only
+ * skips ASCII 16 bytes at a time and checks every other sequence byte by byte.
+ */
+bool StringScanner::ValidUTF8SSE2(const char* data, const std::size_t length)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+  std::size_t i = 0;
+  while (i < length)
+  {
+    if (i + 16 <= length)
+    {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+      const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+      if (mask == 0)
+      {
+        i += 16;
+        continue;
+      }
+      i += std::countr_zero(mask);
+    }
+    else if (bytes[i] < 0x80)
+    {
+      i++;
+      continue;
+    }
+
+    const std::size_t sequence = SequenceLength(bytes + i, length - i);
+    if (sequence == 0) return false;
+    i += sequence;
+  }
+  return true;
+}
+
+namespace
+{
+  // Error classes of the AVX2 UTF-8 validator. Every pair of adjacent bytes is looked up by
+  // the high nibble of the first byte, the low nibble of the first byte and the high nibble
+  // of the second; a class set in all three lookups is an error.
+  constexpr uint8_t TooShort = 1 << 0;     // Lead byte followed by a lead byte or ASCII
+  constexpr uint8_t TooLong = 1 << 1;      // ASCII followed by a continuation byte
+  constexpr uint8_t Overlong3 = 1 << 2;    // E0 followed by 80-9F
+  constexpr uint8_t TooLarge = 1 << 3;     // F4 followed by 90-BF, or F5 and above
+  constexpr uint8_t Surrogate = 1 << 4;    // ED followed by A0-BF
+  constexpr uint8_t Overlong2 = 1 << 5;    // C0 or C1
+  constexpr uint8_t TooLarge1000 = 1 << 6; // F5 and above followed by 80-8F
+  constexpr uint8_t Overlong4 = 1 << 6;    // F0 followed by 80-8F
+  constexpr uint8_t TwoContinuations = 1 << 7;
+  constexpr uint8_t Carry = TooShort | TooLong | TwoContinuations; // Classes decided by the high nibble alone
+
+  alignas(16) constexpr uint8_t FirstHighTable[16] = {
+    TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+    TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+    TooShort | Overlong2,
+    TooShort,
+    TooShort | Overlong3 | Surrogate,
+    TooShort | TooLarge | TooLarge1000 | Overlong4,
+  };
+
+  alignas(16) constexpr uint8_t FirstLowTable[16] = {
+    Carry | Overlong3 | Overlong2 | Overlong4,
+    Carry | Overlong2,
+    Carry,
+    Carry,
+    Carry | TooLarge,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000 | Surrogate,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+  };
+
+  alignas(16) constexpr uint8_t SecondHighTable[16] = {
+    TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+    TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+    TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+    TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+    TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+    TooShort, TooShort, TooShort, TooShort,
+  };
+
+  // A chunk ending in one of these may not end a string: the last byte must not start a
+  // sequence, the second to last not a three or four byte one, the third to last not a four byte one.
+  alignas(32) constexpr uint8_t IncompleteLimit[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+  };
+
+  JSON_TARGET("avx2")
+  __m256i LoadTable(const uint8_t (&table)[16])
+  {
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+  }
+
+  /// `input` moved up by N bytes, with the last N bytes of `previous` moved in at the front.
+  template <int N>
+  JSON_TARGET("avx2")
+  __m256i Previous(const __m256i input, const __m256i previous)
+  {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+  }
+
+  /// Error bits for the 32 bytes of `input`, which follow the 32 bytes of `previous`.
+  JSON_TARGET("avx2")
+  __m256i CheckUTF8(const __m256i input, const __m256i previous)
+  {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i first = Previous<1>(input, previous);
+
+    const __m256i firstHigh = _mm256_shuffle_epi8(LoadTable(FirstHighTable), _mm256_and_si256(_mm256_srli_epi16(first, 4), nibble));
+    const __m256i firstLow = _mm256_shuffle_epi8(LoadTable(FirstLowTable), _mm256_and_si256(first, nibble));
+    const __m256i secondHigh = _mm256_shuffle_epi8(LoadTable(SecondHighTable), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(firstHigh, firstLow), secondHigh);
+
+    // The third and fourth bytes of a sequence must be continuations, which the pair lookup
+    // sees as TwoContinuations. Anywhere else, two continuations in a row are an error.
+    const __m256i third = _mm256_subs_epu8(Previous<2>(input, previous), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    const __m256i fourth = _mm256_subs_epu8(Previous<3>(input, previous), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    const __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(mustContinue, special);
+  }
+}
+
+/**
+ * The lookup algorithm of Keiser and Lemire ("Validating UTF-8 In Less Than One Instruction
+ * Per Byte"): three table lookups per 32 bytes classify every pair of adjacent bytes, and two
+ * saturating subtractions find the bytes that must continue a three or four byte sequence.
+ * Errors are accumulated and tested once at the end, so there are no branches but the
+ * all-ASCII shortcut. The tail is copied into a zero-padded chunk.
+ */
+JSON_TARGET("avx2")
+bool StringScanner::ValidUTF8AVX2(const char* data, const std::size_t length)
+{
+  const __m256i incompleteLimit = _mm256_load_si256(reinterpret_cast<const __m256i*>(IncompleteLimit));
+  __m256i error = _mm256_setzero_si256();
+  __m256i previous = _mm256_setzero_si256();
+  __m256i previousIncomplete = _mm256_setzero_si256();
+
+  alignas(32) char tail[32];
+  for (std::size_t i = 0; i <= length; i += 32)
+  {
+    const char* chunk = data + i;
+    if (i + 32 > length)
+    {
+      std::memset(tail, 0, sizeof(tail));
+      if (i < length) std::memcpy(tail, data + i, length - i);
+      chunk = tail;
+    }
+
+    const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk));
+    if (_mm256_movemask_epi8(input) == 0)
+    {
+      // ASCII only, which is fine unless the previous chunk ended inside a sequence.
+      error = _mm256_or_si256(error, previousIncomplete);
+    }
+    else
+    {
+      error = _mm256_or_si256(error, CheckUTF8(input, previous));
+      previousIncomplete = _mm256_subs_epu8(input, incompleteLimit);
+    }
+    previous = input;
+  }
+
+  error = _mm256_or_si256(error, previousIncomplete);
+  return _mm256_testz_si256(error, error) != 0;
+}
+
+namespace
+{
+  constexpr uint64_t Ones = 0x0101010101010101ULL;
+  constexpr uint64_t High = 0x8080808080808080ULL;
+
+  uint64_t LoadWord(const char* data)
+  {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+  }
+
+  /// The top bit of every byte of `word` that is zero. A borrow can only mark bytes above a
+  /// zero byte, so the lowest bit set is always exact.
+  uint64_t ZeroBytes(const uint64_t word)
+  {
+    return (word - Ones) & ~word & High;
+  }
+
+  uint64_t BackslashBytes(const uint64_t word)
+  {
+    return ZeroBytes(word ^ (Ones * '\\'));
+  }
+
+  /// Bytes below 0x20 are found the same way as zero bytes, by subtracting 0x20 instead of 1.
+  uint64_t EscapableBytes(const uint64_t word)
+  {
+    return BackslashBytes(word) | ZeroBytes(word ^ (Ones * '"')) | ((word - Ones * 0x20) & ~word & High);
+  }
+
+  /// Index of the first byte of a word marked in `bytes`, counting from `offset`, or `length`.
+  std::size_t FirstInWord(const uint64_t bytes, const std::size_t offset, const std::size_t length)
+  {
+    return bytes != 0 ? offset + std::countr_zero(bytes) / 8 : length;
+  }
+
+  std::size_t FirstInMask(const uint32_t mask, const std::size_t offset, const std::size_t length)
+  {
+    return mask != 0 ? offset + std::countr_zero(mask) : length;
+  }
+
+  JSON_TARGET("avx2")
+  uint32_t BackslashMask(const __m256i chunk)
+  {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))));
+  }
+
+  // The 128-bit variants are compiled for AVX2 too, so they are VEX-encoded and can run
+  // after 256-bit code without an AVX to SSE transition.
+  JSON_TARGET("avx2")
+  uint32_t BackslashMask(const __m128i chunk)
+  {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))));
+  }
+
+  /// Bytes up to 0x1F are found as the bytes that max(byte, 0x1F) leaves unchanged at 0x1F.
+  JSON_TARGET("avx2")
+  uint32_t EscapableMask(const __m256i chunk)
+  {
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    const __m256i matches = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))),
+      _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+  }
+
+  JSON_TARGET("avx2")
+  uint32_t EscapableMask(const __m128i chunk)
+  {
+    const __m128i control = _mm_set1_epi8(0x1F);
+    const __m128i matches = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))),
+      _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+  }
+
+  JSON_TARGET("avx2")
+  __m256i Load32(const char* data)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+  }
+
+  JSON_TARGET("avx2")
+  __m128i Load16(const char* data)
+  {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  }
+}
+
+/**
+ * The tail is searched with loads that end exactly at the end of the data and overlap bytes
+ * already known not to match, so the first match they find is still the first in the data.
+ * A string shorter than 32 bytes is covered by two overlapping 16-byte loads, or two 8-byte
+ * words below 16 bytes, instead of a byte loop. All of it stays inside the AVX2 target:
+ * handing the tail to the SSE2 kernel would run legacy SSE code with the upper halves of the
+ * ymm registers dirty, and pay the AVX to SSE transition penalty on every call.
+ */
+JSON_TARGET("avx2")
+std::size_t StringScanner::FindBackslashAVX2(const char* data, const std::size_t length)
+{
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32)
+  {
+    const uint32_t mask = BackslashMask(Load32(data + i));
+    if (mask != 0) return i + std::countr_zero(mask);
+  }
+
+  if (i == length) return length;
+  if (length >= 32) return FirstInMask(BackslashMask(Load32(data + length - 32)), length - 32, length);
+  if (length >= 16)
+  {
+    const uint32_t head = BackslashMask(Load16(data));
+    if (head != 0) return std::countr_zero(head);
+    return FirstInMask(BackslashMask(Load16(data + length - 16)), length - 16, length);
+  }
+  if (length >= 8)
+  {
+    const uint64_t head = BackslashBytes(LoadWord(data));
+    if (head != 0) return std::countr_zero(head) / 8;
+    return FirstInWord(BackslashBytes(LoadWord(data + length - 8)), length - 8, length);
+  }
+  for (; i < length; i++)
+  {
+    if (data[i] == '\\') return i;
+  }
+  return length;
+}
+
+JSON_TARGET("avx2")
+std::size_t StringScanner::FindEscapableAVX2(const char* data, const std::size_t length)
+{
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32)
+  {
+    const uint32_t mask = EscapableMask(Load32(data + i));
+    if (mask != 0) return i + std::countr_zero(mask);
+  }
+
+  if (i == length) return length;
+  if (length >= 32) return FirstInMask(EscapableMask(Load32(data + length - 32)), length - 32, length);
+  if (length >= 16)
+  {
+    const uint32_t head = EscapableMask(Load16(data));
+    if (head != 0) return std::countr_zero(head);
+    return FirstInMask(EscapableMask(Load16(data + length - 16)), length - 16, length);
+  }
+  if (length >= 8)
+  {
+    const uint64_t head = EscapableBytes(LoadWord(data));
+    if (head != 0) return std::countr_zero(head) / 8;
+    return FirstInWord(EscapableBytes(LoadWord(data + length - 8)), length - 8, length);
+  }
+  for (; i < length; i++)
+  {
+    const auto c = static_cast<unsigned char>(data[i]);
+    if (c == '"' || c == '\\' || c < 0x20) return i;
+  }
+  return length;
+}
+
+#else
+
+std::size_t StringScanner::FindBackslashSSE2(const char* data, const std::size_t length) { return FindBackslashScalar(data, length); }
+std::size_t StringScanner::FindBackslashAVX2(const char* data, const std::size_t length) { return FindBackslashScalar(data, length); }
+std::size_t StringScanner::FindEscapableSSE2(const char* data, const std::size_t length) { return FindEscapableScalar(data, length); }
+std::size_t StringScanner::FindEscapableAVX2(const char* data, const std::size_t length) { return FindEscapableScalar(data, length); }
+bool StringScanner::ValidUTF8SSE2(const char* data, const std::size_t length) { return ValidUTF8Scalar(data, length); }
+bool StringScanner::ValidUTF8AVX2(const char* data, const std::size_t length) { return ValidUTF8Scalar(data, length); }
+
+#endif
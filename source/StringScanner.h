@@ -0,0 +1,60 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <cstddef>
+
+/**
+ * @class StringScanner
+ * @brief Vectorized searches used to copy string contents in bulk, and UTF-8 validation.
+ *
+ * Unescaping only has work to do at backslashes, and escaping only at quotes, backslashes
+ * and control characters. Everything in between is found 16 or 32 bytes at a time and
+ * copied with a single memcpy. SSE2 and AVX2 kernels are provided on x86-64 and the best
+ * one the CPU supports is chosen once at runtime; other platforms use the scalar kernels.
+ *
+ * The UTF-8 validators accept exactly the well-formed sequences of the Unicode standard
+ * (table 3-7): no overlong forms, no surrogates and nothing above U+10FFFF.
+ */
+class StringScanner
+{
+public:
+  /// A kernel returns the index of the first matching byte, or `length` if there is none.
+  using Kernel = std::size_t (*)(const char* data, std::size_t length);
+
+  /// A validator returns whether the bytes are well-formed UTF-8.
+  using Validator = bool (*)(const char* data, std::size_t length);
+
+  struct Kernels
+  {
+    Kernel findBackslash;
+    Kernel findEscapable;
+    Validator validUTF8;
+    const char* name;
+  };
+
+  /// Return the fastest kernels supported by the running CPU.
+  static const Kernels& Select();
+
+  /// Index of the first '\\', or `length`.
+  static std::size_t FindBackslash(const char* data, const std::size_t length) { return Select().findBackslash(data, length); }
+
+  /// Index of the first byte that must be escaped in a JSON string ('"', '\\' or below 0x20), or `length`.
+  static std::size_t FindEscapable(const char* data, const std::size_t length) { return Select().findEscapable(data, length); }
+
+  /// Whether the bytes are well-formed UTF-8.
+  static bool ValidUTF8(const char* data, const std::size_t length) { return Select().validUTF8(data, length); }
+
+  static std::size_t FindBackslashScalar(const char* data, std::size_t length);
+  static std::size_t FindBackslashSSE2(const char* data, std::size_t length);
+  static std::size_t FindBackslashAVX2(const char* data, std::size_t length);
+
+  static std::size_t FindEscapableScalar(const char* data, std::size_t length);
+  static std::size_t FindEscapableSSE2(const char* data, std::size_t length);
+  static std::size_t FindEscapableAVX2(const char* data, std::size_t length);
+
+  static bool ValidUTF8Scalar(const char* data, std::size_t length);
+  static bool ValidUTF8SSE2(const char* data, std::size_t length);
+  static bool ValidUTF8AVX2(const char* data, std::size_t length);
+};
@@ -0,0 +1,184 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "StructuralScanner.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JSON_SCANNER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_TARGET(features) __attribute__((target(features)))
+#else
+#define JSON_TARGET(features)
+#endif
+
+/**
+ * Returns the fastest kernel the running CPU supports. The CPU is only queried once.
+ */
+StructuralScanner::Kernel StructuralScanner::Select()
+{
+  static const Kernel kernel = []() -> Kernel
+  {
+#if JSON_SCANNER_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool sse42 = (info[2] & (1 << 20)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (osxsave && (_xgetbv(0) & 0x6) == 0x6)
+    {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse42 = __builtin_cpu_supports("sse4.2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) return &ScanAVX2;
+    if (sse42) return &ScanSSE42;
+#endif
+    return &ScanScalar;
+  }();
+
+  return kernel;
+}
+
+const char* StructuralScanner::Name(const Kernel kernel)
+{
+  if (kernel == &ScanAVX2) return "avx2";
+  if (kernel == &ScanSSE42) return "sse4.2";
+  return "scalar";
+}
+
+/**
+ * Portable fallback, one byte per step.
+ */
+BlockMasks StructuralScanner::ScanScalar(const char* block)
+{
+  BlockMasks masks{0, 0, 0, 0, 0};
+
+  for (unsigned int i = 0; i < BlockSize; i++)
+  {
+    const uint64_t bit = uint64_t{1} << i;
+    if (static_cast<unsigned char>(block[i]) >= 0x80) masks.nonAscii |= bit;
+    switch (block[i])
+    {
+      case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+      case '"': masks.quote |= bit; break;
+      case '\\': masks.backslash |= bit; break;
+      case '{': case '}': case '[': case ']': case ':': case ',': masks.structural |= bit; break;
+      default: break;
+    }
+  }
+
+  return masks;
+}
+
+#if JSON_SCANNER_X86
+
+/**
+ * SSE4.2 kernel. The whitespace and structural sets are matched with PCMPESTRM,
+ * quotes and backslashes with plain byte compares. Non-ASCII bytes are their own sign bits.
+ */
+JSON_TARGET("sse4.2")
+BlockMasks StructuralScanner::ScanSSE42(const char* block)
+{
+  constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+  const __m128i whitespaceSet = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i structuralSet = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+
+  BlockMasks masks{0, 0, 0, 0, 0};
+
+  for (unsigned int i = 0; i < BlockSize; i += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+
+    const auto whitespace = static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_cmpestrm(whitespaceSet, 4, chunk, 16, mode)));
+    const auto structural = static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_cmpestrm(structuralSet, 6, chunk, 16, mode)));
+    const auto quotes = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+    const auto backslashes = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)));
+    const auto nonAscii = static_cast<uint16_t>(_mm_movemask_epi8(chunk));
+
+    masks.whitespace |= uint64_t{whitespace} << i;
+    masks.structural |= uint64_t{structural} << i;
+    masks.quote |= uint64_t{quotes} << i;
+    masks.backslash |= uint64_t{backslashes} << i;
+    masks.nonAscii |= uint64_t{nonAscii} << i;
+  }
+
+  return masks;
+}
+
+/**
+ * AVX2 kernel, two 32-byte lanes per block with byte compares.
+ */
+JSON_TARGET("avx2")
+BlockMasks StructuralScanner::ScanAVX2(const char* block)
+{
+  BlockMasks masks{0, 0, 0, 0, 0};
+
+  for (unsigned int i = 0; i < BlockSize; i += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+
+    const __m256i whitespace = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+
+    // '[' and ']' differ from '{' and '}' only in bit 0x20.
+    const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+    const __m256i structural = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+
+    const __m256i quotes = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+    const __m256i backslashes = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+
+    masks.whitespace |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(whitespace))} << i;
+    masks.structural |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(structural))} << i;
+    masks.quote |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(quotes))} << i;
+    masks.backslash |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(backslashes))} << i;
+    masks.nonAscii |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(chunk))} << i;
+  }
+
+  return masks;
+}
+
+#else
+
+BlockMasks StructuralScanner::ScanSSE42(const char* block) { return ScanScalar(block); }
+BlockMasks StructuralScanner::ScanAVX2(const char* block) { return ScanScalar(block); }
+
+#endif
+
+/**
+ * Finds the bytes escaped by an odd-length run of backslashes, carrying runs that
+ * cross a block boundary into the next block.
+ */
+uint64_t StructuralScanner::EscapedMask(uint64_t backslash, bool& carry)
+{
+  constexpr uint64_t evenBits = 0x5555555555555555ULL;
+  const uint64_t carryIn = carry ? 1 : 0;
+
+  // A backslash that is itself escaped does not start an escape.
+  backslash &= ~carryIn;
+  const uint64_t followsEscape = (backslash << 1) | carryIn;
+
+  // Runs starting on an odd bit; adding the run flips every bit up to its end.
+  const uint64_t oddStarts = backslash & ~evenBits & ~followsEscape;
+  const uint64_t sequencesStartingOnEvenBits = oddStarts + backslash;
+  carry = sequencesStartingOnEvenBits < oddStarts;
+
+  const uint64_t invert = sequencesStartingOnEvenBits << 1;
+  return (evenBits ^ invert) & followsEscape;
+}
@@ -0,0 +1,57 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <cstdint>
+
+/**
+ * @struct BlockMasks
+ * @brief Character class bitmaps for one 64-byte block of input.
+ *
+ * Bit i of each mask describes byte i of the block.
+ */
+struct BlockMasks
+{
+  uint64_t whitespace; // ' ', '\t', '\n', '\r'
+  uint64_t quote;      // '"'
+  uint64_t backslash;  // '\\'
+  uint64_t structural; // '{', '}', '[', ']', ':', ','
+  uint64_t nonAscii;   // 0x80 and above, the bytes of multi-byte UTF-8 sequences
+};
+
+/**
+ * @class StructuralScanner
+ * @brief Vectorized stage-1 scan that classifies the input 64 bytes at a time.
+ *
+ * The Lexer uses the resulting bitmaps to jump over whitespace and string contents
+ * instead of inspecting one byte per step. SSE4.2 and AVX2 kernels are provided on
+ * x86-64, and the best one the CPU supports is chosen once at runtime. Every other
+ * platform uses the portable scalar kernel.
+ */
+class StructuralScanner
+{
+public:
+  static constexpr unsigned int BlockSize = 64;
+
+  /// A kernel classifies exactly BlockSize readable bytes starting at `block`.
+  using Kernel = BlockMasks (*)(const char* block);
+
+  /// Return the fastest kernel supported by the running CPU.
+  static Kernel Select();
+  static const char* Name(Kernel kernel);
+
+  static BlockMasks ScanScalar(const char* block);
+  static BlockMasks ScanSSE42(const char* block);
+  static BlockMasks ScanAVX2(const char* block);
+
+  /**
+   * @brief Computes which bytes of a block are escaped by a preceding backslash.
+   *
+   * @param backslash The backslash mask of the block.
+   * @param carry In: whether the first byte of the block is escaped. Out: whether the
+   *              first byte of the next block is escaped.
+   * @return A mask with a bit set for every escaped byte.
+   */
+  static uint64_t EscapedMask(uint64_t backslash, bool& carry);
+};
@@ -0,0 +1,142 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs independent tasks on a fixed number of threads.
+ *
+ * The worker threads are started once, by the constructor, and wait for work between calls
+ * to ParallelFor(), so a parse that hands out work in several rounds pays for starting
+ * threads only once. The destructor stops and joins them.
+ */
+class ThreadPool
+{
+public:
+  /// Return `requested`, or the number of hardware threads if it is zero.
+  static unsigned int Resolve(const unsigned int requested)
+  {
+    if (requested != 0) return requested;
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+  }
+
+  /// Start a pool of `threads` threads, counting the thread that calls ParallelFor().
+  explicit ThreadPool(const unsigned int threads)
+  {
+    for (unsigned int t = 1; t < threads; t++) m_workers.emplace_back([this]() { WaitForWork(); });
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Calls `task(i)` for every i in [0, count) on the pool's threads.
+   *
+   * The calling thread takes part in the work. Tasks are handed out in index order.
+   * If any task throws, no further tasks are started, and the exception of the
+   * lowest failing index among those that ran is rethrown once all threads are done.
+   */
+  template <typename Task>
+  void ParallelFor(const std::size_t count, Task&& task)
+  {
+    m_task = [](void* context, const std::size_t i) { (*static_cast<std::remove_reference_t<Task>*>(context))(i); };
+    m_context = const_cast<void*>(static_cast<const void*>(&task));
+    m_count = count;
+    m_next = 0;
+    m_failed = false;
+    m_errorIndex = count;
+    m_error = nullptr;
+
+    {
+      std::lock_guard lock(m_mutex);
+      m_busy = m_workers.size();
+      m_round++;
+    }
+    m_wake.notify_all();
+
+    Work();
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_busy == 0; });
+    if (m_error) std::rethrow_exception(m_error);
+  }
+
+private:
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_wake; // A new round of work, or the pool is stopping
+  std::condition_variable m_done; // The last worker has finished the round
+  std::size_t m_round = 0;        // Number of ParallelFor() calls so far
+  std::size_t m_busy = 0;         // Workers that have not finished the round yet
+  bool m_stop = false;
+
+  // The current round. Set before the workers are woken and kept until all of them are done.
+  void (*m_task)(void* context, std::size_t i) = nullptr;
+  void* m_context = nullptr;
+  std::size_t m_count = 0;
+  std::atomic<std::size_t> m_next{0};
+  std::atomic<bool> m_failed{false};
+  std::size_t m_errorIndex = 0;
+  std::exception_ptr m_error;
+
+  void WaitForWork()
+  {
+    std::size_t round = 0;
+    while (true)
+    {
+      {
+        std::unique_lock lock(m_mutex);
+        m_wake.wait(lock, [&]() { return m_stop || m_round != round; });
+        if (m_stop) return;
+        round = m_round;
+      }
+
+      Work();
+
+      std::lock_guard lock(m_mutex);
+      if (--m_busy == 0) m_done.notify_one();
+    }
+  }
+
+  void Work()
+  {
+    for (std::size_t i = m_next++; i < m_count && !m_failed; i = m_next++)
+    {
+      try
+      {
+        m_task(m_context, i);
+      }
+      catch (...)
+      {
+        std::lock_guard lock(m_mutex);
+        if (i < m_errorIndex)
+        {
+          m_errorIndex = i;
+          m_error = std::current_exception();
+        }
+        m_failed = true;
+      }
+    }
+  }
+};
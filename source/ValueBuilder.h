@@ -0,0 +1,68 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#pragma once
+#include "JSON.h"
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Copies a read-only view of a JSON document, such as a JSONNode, into a JSONValue tree.
+ *
+ * `shallow(view)` converts a scalar completely, and turns an array or object into an empty one
+ * with room reserved for all of its children. `children(view, add)` calls `add(key, child)` for
+ * every element or member in document order; the key of an element is ignored.
+ *
+ * Containers are filled in from the top down, from a stack on the heap rather than the call
+ * stack, so the view may nest as deeply as its parser allowed. A repeated key keeps the position
+ * of its first occurrence and the value of its last, as with the JSONValue parse.
+ */
+template <typename View, typename Shallow, typename Children>
+JSONValue BuildJSONValue(const View& root, Shallow shallow, Children children)
+{
+  // Containers whose children have not been added yet. Their capacity was reserved up front,
+  // so the pointers stay valid while their siblings are added.
+  std::vector<std::pair<View, JSONValue*>> pending;
+  std::vector<std::pair<View, JSONValue*>> members; // The members of one object, by position
+
+  const auto isContainer = [](const JSONValue& value) { return value.IsJSONArray() || value.IsJSONObject(); };
+
+  JSONValue result = shallow(root);
+  if (isContainer(result)) pending.emplace_back(root, &result);
+
+  while (!pending.empty())
+  {
+    const auto [view, target] = pending.back();
+    pending.pop_back();
+
+    if (target->IsJSONArray())
+    {
+      auto& array = std::get<std::vector<JSONValue>>(target->data);
+      children(view, [&](std::string_view, const View& child)
+      {
+        JSONValue& element = array.emplace_back(shallow(child));
+        if (isContainer(element)) pending.emplace_back(child, &element);
+      });
+      continue;
+    }
+
+    auto& object = std::get<JSONObject>(target->data);
+    members.clear();
+    children(view, [&](const std::string_view key, const View& child)
+    {
+      const std::size_t size = object.size();
+      JSONValue& member = object[key];
+      member = shallow(child);
+      if (object.size() != size) members.emplace_back(child, &member);
+      else members[static_cast<std::size_t>(object.find(key) - object.begin())] = {child, &member};
+    });
+
+    for (const auto& member : members)
+    {
+      if (isContainer(*member.second)) pending.push_back(member);
+    }
+  }
+  return result;
+}
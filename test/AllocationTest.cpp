@@ -0,0 +1,70 @@
+//
+// Created by sebastian on 10/16/26.
+//
+
+#include "Bench.h"
+#include "JSONParser.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * Checks that a long-lived JSONParser makes no heap allocation in steady state.
+ *
+ * Every message is parsed once to let the parser and its outputs grow, then the whole
+ * stream is parsed again while counting allocations through the operator new and delete
+ * replacements in bench/Allocations.cpp. Arena chunks come from malloc, so they are
+ * counted through the document instead.
+ */
+int main()
+{
+  std::vector<std::string> messages;
+  for (std::size_t i = 0; i < 200; i++) messages.push_back(Bench::GenerateRecords(1 + i % 4));
+  messages.push_back(R"({"deep": [[[[{"a": [1, 2.5e3, -0.25]}]]]], "escaped": "tab\t quote\" é", "empty": {}})");
+
+  int failures = 0;
+  const auto check = [&failures](const char* name, const std::size_t allocations)
+  {
+    std::printf("%-36s %zu allocations\n", name, allocations);
+    if (allocations != 0) failures++;
+  };
+
+  JSONParser parser;
+
+  JSONDocument document;
+  for (const std::string& message : messages) parser.Parse(message, document);
+  {
+    const std::size_t before = Bench::AllocationCount();
+    const std::size_t chunksBefore = document.ArenaAllocationCount();
+    for (const std::string& message : messages) parser.Parse(message, document);
+    check("JSONParser into one JSONDocument", Bench::AllocationCount() - before + document.ArenaAllocationCount() - chunksBefore);
+  }
+
+  JSONTape tape;
+  for (const std::string& message : messages) parser.Parse(message, tape);
+  {
+    const std::size_t before = Bench::AllocationCount();
+    for (const std::string& message : messages) parser.Parse(message, tape);
+    check("JSONParser onto one JSONTape", Bench::AllocationCount() - before);
+  }
+
+  // The hook must see every form of operator new, or a zero above proves nothing.
+  {
+    const std::size_t before = Bench::AllocationCount();
+    struct alignas(64) Line { char bytes[64]; };
+    const auto allocate = [](auto* pointer) { Bench::DoNotOptimize(pointer); delete pointer; };
+    allocate(new int(1));
+    allocate(new (std::nothrow) int(1));
+    allocate(new Line());
+    allocate(new (std::nothrow) Line());
+    if (Bench::AllocationCount() - before != 4)
+    {
+      std::printf("the allocation hook missed a form of operator new\n");
+      failures++;
+    }
+  }
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}